@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Task.h"
+#include "TaskQueue.h"
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <ostream>
+
+/**
+ * @class AdmissionController
+ * @brief Decides what happens to a Task offered to a full queue, based on where it comes from and what kind it is.
+ *
+ * Each (TaskSource, TaskType) pair has its own OverflowPolicy. The defaults model a browser under load:
+ *   - External macrotasks (input events, timers) are shed oldest-first: stale events are worth less than new ones.
+ *   - External microtasks (promise resolutions) block the producer: they must not be lost.
+ *   - Tasks created by the EventLoop (API requests of running code) shed the oldest fresh external
+ *     macrotask, so new events cannot crowd out the continuations of code that already runs. If there
+ *     is none to shed they are rejected: the EventLoop must never block on the Scheduler, because the
+ *     Scheduler may itself be blocked waiting for room in the EventLoop's queues.
+ *
+ * Every dropped task (rejected or shed) is reported through the `on_dropped` error callback,
+ * so the producer can surface the failure and keep its own bookkeeping consistent.
+ */
+class AdmissionController {
+public:
+    // Invoked with the task that was dropped and the outcome that dropped it (REJECTED or SHED).
+    using DropCallback = std::function<void(const Task&, PushResult)>;
+
+private:
+    static constexpr int SOURCE_COUNT = 3;
+    static constexpr int TYPE_COUNT = 2;
+
+    OverflowPolicy m_policies[SOURCE_COUNT][TYPE_COUNT];
+    DropCallback m_on_dropped;
+
+    std::atomic<unsigned long long> m_admitted{0};
+    std::atomic<unsigned long long> m_rejected{0};
+    std::atomic<unsigned long long> m_shed{0};
+
+    static int index_of(TaskSource source) { return static_cast<int>(source); }
+    static int index_of(TaskType type) { return static_cast<int>(type); }
+
+public:
+    /**
+     * @brief Constructs the controller with the default policies.
+     * @param on_dropped The error callback invoked for every rejected or shed task.
+     */
+    explicit AdmissionController(DropCallback on_dropped)
+        : m_on_dropped(std::move(on_dropped))
+    {
+        set_policy(TaskSource::API_WORKER, TaskType::MACROTASK, OverflowPolicy::SHED_OLDEST);
+        set_policy(TaskSource::API_WORKER, TaskType::MICROTASK, OverflowPolicy::BLOCK);
+        set_policy(TaskSource::EVENT_LOOP, TaskType::MACROTASK, OverflowPolicy::SHED_OLDEST);
+        set_policy(TaskSource::EVENT_LOOP, TaskType::MICROTASK, OverflowPolicy::SHED_OLDEST);
+        set_policy(TaskSource::SCHEDULER, TaskType::MACROTASK, OverflowPolicy::BLOCK);
+        set_policy(TaskSource::SCHEDULER, TaskType::MICROTASK, OverflowPolicy::BLOCK);
+    }
+
+    // The controller holds shared counters and is referenced by every producer; it must not be duplicated.
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    /**
+     * @brief Changes the overflow policy for one kind of task. Must be called before the engine starts.
+     * @throws std::invalid_argument if BLOCK is requested for EventLoop tasks, which could deadlock the engine.
+     */
+    void set_policy(TaskSource source, TaskType type, OverflowPolicy policy) {
+        if (source == TaskSource::EVENT_LOOP && policy == OverflowPolicy::BLOCK) {
+            throw std::invalid_argument("EventLoop tasks cannot use the BLOCK policy: the EventLoop and the Scheduler would wait on each other.");
+        }
+        m_policies[index_of(source)][index_of(type)] = policy;
+    }
+
+    OverflowPolicy policy_for(const Task& task) const {
+        return m_policies[index_of(task.source)][index_of(task.type)];
+    }
+
+    /**
+     * @brief Offers a task to a (possibly bounded) queue using the policy for its kind.
+     * @return The outcome. On REJECTED the task was dropped; on SHED it was enqueued and an older one dropped.
+     */
+    PushResult admit(Task task, TaskQueue<Task>& queue) {
+        // Only sheddable queued tasks (fresh external events) may be shed. An external task may only
+        // displace one of its own kind; a task created by the EventLoop may displace any external
+        // macrotask. API responses and suspended async frames share the Scheduler's queue but are
+        // never sheddable: dropping one would silently lose admitted work.
+        const TaskSource source = task.source;
+        const TaskType type = task.type;
+        const OverflowPolicy policy = policy_for(task);
+        auto is_victim = [source, type](const Task& queued) {
+            if (!queued.sheddable) {
+                return false;
+            }
+            if (source == TaskSource::EVENT_LOOP) {
+                return queued.type == TaskType::MACROTASK;
+            }
+            return queued.source == source && queued.type == type;
+        };
+
+        std::optional<Task> displaced;
+        PushResult result = queue.offer(std::move(task), policy, displaced, is_victim);
+
+        switch (result) {
+            case PushResult::ACCEPTED: ++m_admitted; break;
+            case PushResult::SHED:     ++m_admitted; ++m_shed; break;
+            case PushResult::REJECTED: ++m_rejected; break;
+        }
+        if (displaced && m_on_dropped) {
+            m_on_dropped(*displaced, result);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Prints the admission statistics collected so far. Safe to call from any thread.
+     */
+    void report(std::ostream& out) const {
+        out << "[Admission]: " << m_admitted.load() << " tasks admitted, " << m_rejected.load()
+            << " rejected, " << m_shed.load() << " shed." << std::endl;
+    }
+
+    /**
+     * @brief Parses a policy name as used on the command line.
+     * @throws std::invalid_argument for unknown names.
+     */
+    static OverflowPolicy parse_policy(const std::string& name) {
+        if (name == "block")  return OverflowPolicy::BLOCK;
+        if (name == "reject") return OverflowPolicy::REJECT;
+        if (name == "shed")   return OverflowPolicy::SHED_OLDEST;
+        throw std::invalid_argument("Unknown overflow policy: " + name + " (expected block, reject or shed)");
+    }
+};
@@ -3,6 +3,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <chrono>
 
 /**
  * @class Alarm
@@ -53,6 +54,20 @@ public:
         m_cond_var.wait(lock, m_wakeup_condition);
     }
 
+    /**
+     * @brief Like wait(), but gives up at the given deadline.
+     *
+     * Used by threads that have timed work of their own (e.g., the EventLoop's next frame)
+     * and must wake up even if nobody notifies them.
+     * @param deadline The point in time at which to stop waiting.
+     * @return The value of the wake-up condition when the wait ended ('false' means it timed out).
+     */
+    template <typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cond_var.wait_until(lock, deadline, m_wakeup_condition);
+    }
+
     /**
      * @brief Notifies a waiting thread to re-evaluate its condition.
      *
@@ -14,7 +14,9 @@
 enum class InstructionType {
     LOG,                // Simulates a `console.log()` call.
     API_REQUEST,        // Simulates an API call like `fetch()`.
-    DOM_UPDATE          // Simulates a DOM manipulation (conceptual, not implemented).
+    DOM_UPDATE,         // Simulates a DOM manipulation. Writes are batched and applied by the render phase.
+    ANIMATION_FRAME,    // Simulates `requestAnimationFrame(cb)`: `then_callback_id` runs in the next frame.
+    AWAIT               // Simulates `await fetch(...)`: suspends the callback until the API responds, then resumes it in place.
     // More types could be added in the future.
 };
 
@@ -56,4 +58,26 @@ struct Callback {
     
     // The sequence of operations that make up the body of this "function".
     std::vector<Instruction> instructions;
-};
\ No newline at end of file
+};
+
+/**
+ * @struct AsyncFrame
+ * @brief The resumable execution state of a Callback, i.e. the frame of an `async` function.
+ *
+ * When an AWAIT instruction suspends a callback, its frame is moved to the heap and travels with
+ * the API request Task. When the response arrives, the EventLoop resumes the frame at `ip`
+ * directly, without looking the callback up in the ClosureHeap again. A long async function is
+ * therefore one Callback and one frame instead of a chain of `.then()` callbacks, and every
+ * value it has received so far stays in scope after each await.
+ */
+struct AsyncFrame {
+    // The function being executed. The frame owns its own copy once it has been suspended.
+    Callback callback;
+
+    // The index of the next instruction to execute (the "instruction pointer").
+    std::size_t ip = 0;
+
+    // The function's locals: [0] is the data it was invoked with, [n] the value of its n-th await.
+    // Instruction payloads refer to them as `$0`, `$1`, ... so resumed code can use earlier results.
+    std::vector<std::any> locals;
+};
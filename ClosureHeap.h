@@ -8,6 +8,8 @@
 #include <string>
 #include <random>   // For modern, high-quality random number generation
 #include <limits>   // For std::numeric_limits
+#include <functional> // For the registration listener
+#include <cstdint>
 
 /**
  * @class ClosureHeap
@@ -37,13 +39,28 @@ private:
     // A distribution to map the engine's output to the full range of positive long longs.
     std::uniform_int_distribution<long long> m_distribution;
 
+    // The seed the random engine was initialized with, kept so a session can be recorded and replayed.
+    std::uint64_t m_seed;
+
+    // Optional observer invoked (under the heap's lock) after every successful registration.
+    std::function<void(const Callback&)> m_on_register;
+
 public:
     /**
      * @brief Constructs the ClosureHeap and initializes the random number generator.
      */
     ClosureHeap()
-        : m_random_engine(std::random_device{}()), // Seed with a hardware-based non-deterministic value
-          m_distribution(1, std::numeric_limits<long long>::max())
+        : ClosureHeap(std::random_device{}()) // Seed with a hardware-based non-deterministic value
+    {}
+
+    /**
+     * @brief Constructs the ClosureHeap with a fixed seed, making the generated closure IDs reproducible.
+     * @param seed The seed for the closure ID generator (e.g., the one stored in a replay log).
+     */
+    explicit ClosureHeap(std::uint64_t seed)
+        : m_random_engine(static_cast<std::mt19937::result_type>(seed)),
+          m_distribution(1, std::numeric_limits<long long>::max()),
+          m_seed(seed)
     {}
 
     // The ClosureHeap manages shared, mutable state and is a singleton-like resource,
@@ -64,9 +81,73 @@ public:
         long long closure_id = m_distribution(m_random_engine);
         
         m_callbacks[id] = {id, closure_id, std::move(instructions)};
+        if (m_on_register) {
+            m_on_register(m_callbacks[id]);
+        }
         return id;
     }
 
+    /**
+     * @brief Registers a whole batch of Callbacks under a single lock acquisition.
+     *
+     * The batch receives contiguous IDs in order, so callbacks inside it can reference each other
+     * before their final IDs are known: any `then_callback_id >= 0` is treated as an index into
+     * `bodies` and rewritten to the absolute ID of that entry (-1 still means "no callback").
+     * This is the fast path for bulk loaders, which would otherwise pay one lock and one
+     * tree search per callback.
+     *
+     * @param bodies The instruction lists of the callbacks to register.
+     * @return The ID assigned to `bodies[0]`; entry `i` receives `returned + i`.
+     * @throws std::runtime_error if a link points outside the batch (nothing is registered in that case).
+     */
+    long long register_callbacks(std::vector<std::vector<Instruction>> bodies) {
+        for (const auto& body : bodies) {
+            for (const auto& instruction : body) {
+                if (instruction.then_callback_id >= static_cast<long long>(bodies.size())) {
+                    throw std::runtime_error("Batch link out of range: " + std::to_string(instruction.then_callback_id));
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const long long base = m_next_id;
+        m_next_id += static_cast<long long>(bodies.size());
+
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            for (auto& instruction : bodies[i]) {
+                if (instruction.then_callback_id >= 0) {
+                    instruction.then_callback_id += base;
+                }
+            }
+            long long id = base + static_cast<long long>(i);
+            long long closure_id = m_distribution(m_random_engine);
+
+            // IDs only grow, so inserting at the end of the map is amortized constant time.
+            auto it = m_callbacks.emplace_hint(m_callbacks.end(), id, Callback{id, closure_id, std::move(bodies[i])});
+            if (m_on_register) {
+                m_on_register(it->second);
+            }
+        }
+        return base;
+    }
+
+    /**
+     * @brief Returns the seed used to initialize the closure ID generator.
+     */
+    std::uint64_t seed() const {
+        return m_seed;
+    }
+
+    /**
+     * @brief Installs an observer that is notified of every newly registered Callback.
+     *        Used by the record mode to capture the callbacks that injected tasks refer to.
+     * @param listener The function to call; it runs while the heap's mutex is held, so it must not call back into the heap.
+     */
+    void set_on_register(std::function<void(const Callback&)> listener) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_on_register = std::move(listener);
+    }
+
     /**
      * @brief Retrieves a copy of the Callback associated with a given ID.
      * @param id The unique ID of the callback to retrieve.
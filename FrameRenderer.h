@@ -0,0 +1,232 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @class FrameRenderer
+ * @brief Models the optional render step of the Event Loop: `requestAnimationFrame` callbacks,
+ *        batched DOM updates and frame-budget (jank) accounting.
+ *
+ * The renderer runs on a fixed vsync-like timeline (e.g., every 16.6 ms at 60 fps). DOM_UPDATE
+ * instructions do not touch the "DOM" immediately; they are collected into the current frame's
+ * batch, where later writes to the same target replace earlier ones, and the batch is applied
+ * once per frame. As in browsers, a frame is only produced when there is something to render.
+ *
+ * A frame that is rendered more than one frame interval after its deadline is counted as janky,
+ * and the longest task executed since the frame was armed is blamed for it.
+ *
+ * Everything except frame_pending() and the statistics is used only from the EventLoop thread.
+ * The statistics are guarded by a mutex so that another thread can print a report.
+ */
+class FrameRenderer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    bool m_enabled;
+    Clock::duration m_frame_interval;
+    Clock::time_point m_origin;                 // Frame boundaries are origin + k * interval.
+
+    // Pending work for the next frame.
+    std::vector<long long> m_animation_callbacks;
+    std::map<std::string, std::string> m_dom_batch;  // target → latest value (ordered for stable output).
+    std::size_t m_dom_writes = 0;                    // Writes received for the batch, before coalescing.
+    Clock::time_point m_frame_deadline{};            // Deadline of the frame being accumulated; unset when idle.
+    std::atomic<bool> m_frame_pending{false};        // Mirrors "a frame is armed" for readers on other threads.
+
+    // The longest task executed since the current frame was armed, blamed if the frame turns out janky.
+    long long m_longest_task_callback = -1;
+    Clock::duration m_longest_task_duration{0};
+
+    // Statistics.
+    mutable std::mutex m_stats_mutex;
+    unsigned long long m_frames = 0;
+    unsigned long long m_janky_frames = 0;
+    unsigned long long m_coalesced_writes = 0;
+    Clock::duration m_total_overrun{0};
+    Clock::duration m_worst_overrun{0};
+    std::unordered_map<long long, unsigned long long> m_jank_by_callback;
+
+public:
+    /**
+     * @brief Constructs the renderer.
+     * @param frames_per_second The target frame rate. 0 disables the render phase entirely.
+     */
+    explicit FrameRenderer(unsigned frames_per_second)
+        : m_enabled(frames_per_second > 0),
+          m_frame_interval(frames_per_second > 0
+              ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frames_per_second))
+              : Clock::duration::zero()),
+          m_origin(Clock::now())
+    {}
+
+    // The renderer owns per-frame state tied to the EventLoop thread; it must not be duplicated.
+    FrameRenderer(const FrameRenderer&) = delete;
+    FrameRenderer& operator=(const FrameRenderer&) = delete;
+
+private:
+    // Fixes the deadline of the frame being accumulated when its first piece of work arrives.
+    // Tasks that finished before this point cannot delay the new frame, so they are no longer
+    // candidates for blame; the task that is arming the frame is noted when it finishes.
+    void arm_frame() {
+        if (m_frame_deadline == Clock::time_point{}) {
+            m_frame_deadline = next_frame_time();
+            m_frame_pending.store(true, std::memory_order_release);
+            m_longest_task_callback = -1;
+            m_longest_task_duration = Clock::duration::zero();
+        }
+    }
+
+public:
+    bool enabled() const { return m_enabled; }
+
+    /**
+     * @brief Schedules a callback for the next frame, like `requestAnimationFrame(cb)`.
+     */
+    void request_animation_frame(long long callback_id) {
+        arm_frame();
+        m_animation_callbacks.push_back(callback_id);
+    }
+
+    /**
+     * @brief Adds a DOM_UPDATE to the current frame's batch.
+     * @param payload Either `target=value` or a bare target. A later write to the same target
+     *        within the same frame replaces the earlier one.
+     */
+    void queue_dom_update(const std::string& payload) {
+        std::size_t separator = payload.find('=');
+        std::string target = payload.substr(0, separator);
+        std::string value = separator == std::string::npos ? std::string() : payload.substr(separator + 1);
+        arm_frame();
+        m_dom_batch[target] = std::move(value);
+        ++m_dom_writes;
+    }
+
+    /**
+     * @brief Records how long a task took, so the longest one can be blamed for a janky frame.
+     */
+    void note_task(long long callback_id, Clock::duration duration) {
+        if (duration > m_longest_task_duration) {
+            m_longest_task_duration = duration;
+            m_longest_task_callback = callback_id;
+        }
+    }
+
+    /** @return true if a frame has something to render (animation callbacks or DOM writes). */
+    bool has_pending_work() const {
+        return m_enabled && (!m_animation_callbacks.empty() || !m_dom_batch.empty());
+    }
+
+    /** @return The first frame boundary at or after `now`. */
+    Clock::time_point next_frame_time(Clock::time_point now = Clock::now()) const {
+        if (!m_enabled) {
+            return now;
+        }
+        auto frames_elapsed = (now - m_origin + m_frame_interval - Clock::duration(1)) / m_frame_interval;
+        return m_origin + frames_elapsed * m_frame_interval;
+    }
+
+    /** @return true while a frame has been armed but not committed yet. Safe to call from any thread. */
+    bool frame_pending() const {
+        return m_frame_pending.load(std::memory_order_acquire);
+    }
+
+    /** @return The deadline of the frame currently being accumulated (meaningful only with pending work). */
+    Clock::time_point frame_deadline() const { return m_frame_deadline; }
+
+    /**
+     * @brief Tells whether the render phase should run now.
+     *
+     * The deadline of a frame is the first boundary after its first piece of work was queued;
+     * the loop keeps processing tasks until that boundary passes, then renders.
+     */
+    bool frame_due(Clock::time_point now) const {
+        return has_pending_work() && now >= m_frame_deadline;
+    }
+
+    /**
+     * @brief Hands over the animation callbacks of this frame. Callbacks requested while they
+     *        run are deferred to the following frame, as in browsers.
+     */
+    std::vector<long long> take_animation_callbacks() {
+        std::vector<long long> callbacks;
+        callbacks.swap(m_animation_callbacks);
+        return callbacks;
+    }
+
+    /**
+     * @brief Applies the coalesced DOM batch and updates the frame-budget statistics.
+     * @param now The time at which the render phase started.
+     */
+    void commit_frame(Clock::time_point now) {
+        std::cout << "  [EventLoop::Render] Committing frame at +"
+                  << std::chrono::duration_cast<std::chrono::microseconds>(now - m_origin).count() << " us: "
+                  << m_dom_batch.size() << " DOM update(s) from " << m_dom_writes << " write(s)." << std::endl;
+        for (const auto& [target, value] : m_dom_batch) {
+            std::cout << "    [Render] " << target << (value.empty() ? "" : " = " + value) << std::endl;
+        }
+
+        Clock::duration overrun = now - m_frame_deadline;
+        {
+            std::lock_guard<std::mutex> lock(m_stats_mutex);
+            ++m_frames;
+            m_coalesced_writes += m_dom_writes - m_dom_batch.size();
+            if (overrun > m_frame_interval) {
+                ++m_janky_frames;
+                m_total_overrun += overrun;
+                m_worst_overrun = std::max(m_worst_overrun, overrun);
+                if (m_longest_task_callback != -1) {
+                    ++m_jank_by_callback[m_longest_task_callback];
+                }
+            }
+        }
+        if (overrun > m_frame_interval) {
+            std::cout << "  [EventLoop::Render] JANK: frame rendered "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(overrun).count()
+                      << " us late. Longest task: callback " << m_longest_task_callback << " ("
+                      << std::chrono::duration_cast<std::chrono::microseconds>(m_longest_task_duration).count()
+                      << " us)." << std::endl;
+        }
+
+        m_dom_batch.clear();
+        m_dom_writes = 0;
+        if (m_animation_callbacks.empty()) {
+            m_frame_deadline = Clock::time_point{};
+            m_frame_pending.store(false, std::memory_order_release);
+        } else {
+            // Callbacks requested from inside this frame's rAF callbacks belong to the next frame:
+            // its deadline is the first boundary strictly after this one, so animation loops stay paced.
+            m_frame_deadline = next_frame_time(std::max(now, m_frame_deadline) + Clock::duration(1));
+        }
+        m_longest_task_callback = -1;
+        m_longest_task_duration = Clock::duration::zero();
+    }
+
+    /**
+     * @brief Prints the frame-budget statistics collected so far. Safe to call from any thread.
+     */
+    void report(std::ostream& out) const {
+        if (!m_enabled) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        auto to_us = [](Clock::duration d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+        out << "[Render]: " << m_frames << " frames rendered, " << m_janky_frames << " janky (budget "
+            << to_us(m_frame_interval) << " us, worst overrun " << to_us(m_worst_overrun) << " us, total "
+            << to_us(m_total_overrun) << " us), " << m_coalesced_writes << " DOM writes coalesced." << std::endl;
+
+        std::vector<std::pair<long long, unsigned long long>> offenders(m_jank_by_callback.begin(), m_jank_by_callback.end());
+        std::sort(offenders.begin(), offenders.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        for (std::size_t i = 0; i < offenders.size() && i < 5; ++i) {
+            out << "  [Render] Callback " << offenders[i].first << " caused " << offenders[i].second << " janky frame(s)." << std::endl;
+        }
+    }
+};
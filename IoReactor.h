@@ -0,0 +1,221 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <ctime>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#else
+#include <mutex>
+#include <condition_variable>
+#endif
+
+/**
+ * @class IoReactor
+ * @brief A single-threaded, non-blocking I/O event loop for the ApiManager, in the spirit of libuv.
+ *
+ * Instead of parking one blocked thread per API request, the ApiManager registers each request
+ * as an operation in the reactor and waits for completions of all of them at once. A single
+ * thread can therefore keep tens of thousands of requests in flight.
+ *
+ * - API requests are modelled as timed operations (the simulated network latency); they live in
+ *   a min-heap ordered by deadline, as libuv keeps its timers. No network I/O is performed.
+ * - Other threads wake the reactor with notify(), which replaces the Alarm for this thread.
+ *
+ * On Linux both sources of events are file descriptors in one epoll set: completions come from a
+ * `timerfd` armed to the earliest deadline in the heap, and notifications from an `eventfd`. The
+ * thread sleeps in `epoll_wait` with no timeout until the kernel reports one of them ready.
+ * Elsewhere a portable fallback with a condition variable and a timed wait provides the same interface.
+ *
+ * Apart from notify(), which may be called from any thread, the reactor must only be used by
+ * the thread that owns it.
+ */
+class IoReactor {
+private:
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        long long token;
+        bool operator>(const Timer& other) const { return deadline > other.deadline; }
+    };
+
+    // Pending timed operations, earliest deadline on top.
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers;
+
+#if defined(__linux__)
+    int m_epoll_fd;
+    int m_wakeup_fd; // eventfd written by notify().
+    int m_timer_fd;  // timerfd that expires at the earliest deadline in m_timers.
+    std::chrono::steady_clock::time_point m_armed_deadline{}; // What m_timer_fd is armed to (epoch = disarmed).
+
+    // Arms the timerfd to the earliest pending deadline, or disarms it when there is none. steady_clock
+    // is CLOCK_MONOTONIC on Linux, so the deadline can be used as an absolute expiry time directly.
+    void arm_timer() {
+        auto deadline = m_timers.empty() ? std::chrono::steady_clock::time_point{} : m_timers.top().deadline;
+        if (deadline == m_armed_deadline) {
+            return;
+        }
+        itimerspec spec{};
+        if (!m_timers.empty()) {
+            auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+            spec.it_value.tv_sec = static_cast<time_t>(since_epoch.count() / 1000000000);
+            spec.it_value.tv_nsec = static_cast<long>(since_epoch.count() % 1000000000);
+        }
+        if (timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+            throw system_error("timerfd_settime");
+        }
+        m_armed_deadline = deadline;
+    }
+
+    // Registers `fd` for readability in the epoll set.
+    bool watch(int fd) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        return epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    static std::runtime_error system_error(const std::string& what) {
+        return std::runtime_error("IoReactor: " + what + " failed: " + std::strerror(errno));
+    }
+#else
+    std::mutex m_mutex;
+    std::condition_variable m_cond_var;
+    bool m_notified = false;
+#endif
+
+    // Moves every expired timer into `completed`.
+    void collect_expired(std::vector<long long>& completed) {
+        auto now = std::chrono::steady_clock::now();
+        while (!m_timers.empty() && m_timers.top().deadline <= now) {
+            completed.push_back(m_timers.top().token);
+            m_timers.pop();
+        }
+    }
+
+public:
+    /**
+     * @brief Creates the reactor's kernel objects.
+     * @throws std::runtime_error if the epoll instance, the eventfd or the timerfd cannot be created.
+     */
+    IoReactor() {
+#if defined(__linux__)
+        m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll_fd == -1) {
+            throw system_error("epoll_create1");
+        }
+        m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wakeup_fd == -1) {
+            close(m_epoll_fd);
+            throw system_error("eventfd");
+        }
+        m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_timer_fd == -1) {
+            close(m_wakeup_fd);
+            close(m_epoll_fd);
+            throw system_error("timerfd_create");
+        }
+        if (!watch(m_wakeup_fd) || !watch(m_timer_fd)) {
+            std::runtime_error error = system_error("epoll_ctl");
+            close(m_timer_fd);
+            close(m_wakeup_fd);
+            close(m_epoll_fd);
+            throw error;
+        }
+#endif
+    }
+
+    ~IoReactor() {
+#if defined(__linux__)
+        close(m_timer_fd);
+        close(m_wakeup_fd);
+        close(m_epoll_fd);
+#endif
+    }
+
+    // The reactor owns kernel handles; copying it would close them twice.
+    IoReactor(const IoReactor&) = delete;
+    IoReactor& operator=(const IoReactor&) = delete;
+
+    /**
+     * @brief Wakes up the thread blocked in wait(). Safe to call from any thread.
+     *        Notifications are sticky: a notify() issued before wait() makes the next wait() return at once.
+     */
+    void notify() {
+#if defined(__linux__)
+        std::uint64_t one = 1;
+        // A full eventfd counter (EAGAIN) still means "readable", so the result can be ignored.
+        [[maybe_unused]] ssize_t written = write(m_wakeup_fd, &one, sizeof(one));
+#else
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_notified = true;
+        }
+        m_cond_var.notify_one();
+#endif
+    }
+
+    /**
+     * @brief Starts a timed operation that completes with `token` after `delay`.
+     */
+    void start_timer(long long token, std::chrono::microseconds delay) {
+        m_timers.push({std::chrono::steady_clock::now() + delay, token});
+    }
+
+    /**
+     * @brief Blocks until at least one operation completes or notify() is called.
+     *
+     * Every operation that is complete when the wait returns is reported in the same batch.
+     * @param completed Receives the tokens of the completed operations (appended, not cleared).
+     * @return true if the wait was ended by notify(), false otherwise.
+     */
+    bool wait(std::vector<long long>& completed) {
+        collect_expired(completed);
+        // If something already completed, still poll, so a pending notification is consumed with this batch.
+        const bool poll_only = !completed.empty();
+
+        bool notified = false;
+#if defined(__linux__)
+        arm_timer();
+        epoll_event events[2]; // The eventfd and the timerfd are the only registered descriptors.
+        int ready = epoll_wait(m_epoll_fd, events, 2, poll_only ? 0 : -1);
+        if (ready == -1 && errno != EINTR) {
+            throw system_error("epoll_wait");
+        }
+        for (int i = 0; i < ready; ++i) {
+            // Both descriptors are drained by reading their 8-byte counter (notifications or expirations).
+            std::uint64_t count;
+            [[maybe_unused]] ssize_t drained = read(events[i].data.fd, &count, sizeof(count));
+            if (events[i].data.fd == m_wakeup_fd) {
+                notified = true;
+            } else {
+                m_armed_deadline = {}; // A one-shot timerfd disarms itself when it expires.
+            }
+        }
+#else
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto woken = [this]() { return m_notified; };
+        if (!poll_only && m_timers.empty()) {
+            m_cond_var.wait(lock, woken);
+        } else if (!poll_only) {
+            m_cond_var.wait_until(lock, m_timers.top().deadline, woken);
+        }
+        notified = m_notified;
+        m_notified = false;
+        lock.unlock();
+#endif
+
+        collect_expired(completed);
+        return notified;
+    }
+};
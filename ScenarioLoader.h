@@ -0,0 +1,228 @@
+#pragma once
+
+#include "Callback.h"
+#include "ClosureHeap.h"
+#include <istream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+
+/**
+ * @struct ScenarioInjection
+ * @brief A task that a scenario schedules for injection into the engine.
+ */
+struct ScenarioInjection {
+    long long at_ms;        // Offset from the start of the scenario.
+    bool is_promise;        // true → routed as a microtask, false → as a macrotask.
+    long long callback_id;  // Absolute ClosureHeap ID once the scenario has been loaded.
+    std::string data;       // The payload handed to the callback.
+};
+
+/**
+ * @class ScenarioLoader
+ * @brief Parses a scenario file describing callback graphs and an injection schedule.
+ *
+ * A scenario replaces the hard-coded `simulate*` functions with a plain text file, so new
+ * workload shapes can be load-tested without recompiling. The format is line based:
+ *
+ * @code
+ *   # Comments and blank lines are ignored.
+ *   callback onClick
+ *     log Button clicked
+ *     fetch api/user/details then onDetails
+ *     request api/legacy then onLegacy
+ *     dom #status=loading
+ *     raf onFrame
+ *     await api/user/settings
+ *     log Settings loaded, resuming in place
+ *   end
+ *
+ *   inject 0   macro   onClick {"type":"click"}
+ *   inject 250 promise onDetails Initial data
+ * @endcode
+ *
+ * `fetch` is an API_REQUEST resolved as a promise (microtask), `request` one resolved as a
+ * macrotask, `dom` a DOM_UPDATE (`target=value`, batched per frame) and `raf` an
+ * ANIMATION_FRAME that runs the named callback in the next render phase. `await <endpoint>`
+ * suspends the callback until the API responds and then resumes it at the next line. In any
+ * payload, `$0` stands for the data the callback was invoked with and `$n` for the value of
+ * its n-th await.
+ *
+ * Callbacks are referenced by name and may be used before they are defined. The input is
+ * streamed line by line and every callback is registered with a single
+ * ClosureHeap::register_callbacks() call, so very large scenarios load in one pass.
+ */
+class ScenarioLoader {
+private:
+    std::vector<std::vector<Instruction>> m_bodies;       // Indexed by batch-local callback index.
+    std::vector<bool> m_defined;
+    std::vector<std::string> m_names;
+    std::unordered_map<std::string, long long> m_index_by_name;
+    std::vector<ScenarioInjection> m_injections;          // callback_id holds the local index until load().
+
+    long long index_of(const std::string& name) {
+        auto it = m_index_by_name.find(name);
+        if (it != m_index_by_name.end()) {
+            return it->second;
+        }
+        long long index = static_cast<long long>(m_bodies.size());
+        m_index_by_name.emplace(name, index);
+        m_bodies.emplace_back();
+        m_defined.push_back(false);
+        m_names.push_back(name);
+        return index;
+    }
+
+    static std::runtime_error error(std::size_t line_number, const std::string& message) {
+        return std::runtime_error("Scenario line " + std::to_string(line_number) + ": " + message);
+    }
+
+    // Returns the rest of the line after the current stream position, without leading whitespace.
+    static std::string rest_of(std::istringstream& in) {
+        std::string rest;
+        std::getline(in >> std::ws, rest);
+        return rest;
+    }
+
+    // Parses `<endpoint> [then <callback>]` for the API request instructions.
+    Instruction parse_request(std::istringstream& in, bool is_promise, std::size_t line_number) {
+        Instruction instruction{InstructionType::API_REQUEST, "", true, is_promise, -1};
+        if (!(in >> instruction.payload)) {
+            throw error(line_number, "API request without an endpoint.");
+        }
+        std::string keyword;
+        if (in >> keyword) {
+            std::string target;
+            if (keyword != "then" || !(in >> target)) {
+                throw error(line_number, "expected 'then <callback>' after the endpoint.");
+            }
+            instruction.then_callback_id = index_of(target);
+        }
+        return instruction;
+    }
+
+public:
+    /**
+     * @brief Parses a scenario from a stream.
+     * @throws std::runtime_error on syntax errors or references to callbacks that are never defined.
+     */
+    explicit ScenarioLoader(std::istream& input) {
+        std::string line;
+        std::size_t line_number = 0;
+        long long current = -1; // Index of the callback being defined, -1 outside a block.
+
+        // A single line stream is reused for the whole file; constructing one per line dominates load time.
+        std::istringstream in;
+        while (std::getline(input, line)) {
+            ++line_number;
+            in.clear();
+            in.str(line);
+            std::string keyword;
+            if (!(in >> keyword) || keyword[0] == '#') {
+                continue;
+            }
+
+            if (current == -1) {
+                if (keyword == "callback") {
+                    std::string name;
+                    if (!(in >> name)) {
+                        throw error(line_number, "callback without a name.");
+                    }
+                    current = index_of(name);
+                    if (m_defined[current]) {
+                        throw error(line_number, "callback '" + name + "' is defined twice.");
+                    }
+                    m_defined[current] = true;
+                } else if (keyword == "inject") {
+                    ScenarioInjection injection;
+                    std::string kind, target;
+                    if (!(in >> injection.at_ms >> kind >> target) || (kind != "promise" && kind != "macro")) {
+                        throw error(line_number, "expected 'inject <ms> promise|macro <callback> [data]'.");
+                    }
+                    injection.is_promise = (kind == "promise");
+                    injection.callback_id = index_of(target);
+                    injection.data = rest_of(in);
+                    m_injections.push_back(std::move(injection));
+                } else {
+                    throw error(line_number, "unknown directive '" + keyword + "'.");
+                }
+                continue;
+            }
+
+            // Inside a callback block: one instruction per line.
+            // Note: parse_request() may grow m_bodies, so the body is always re-indexed after parsing.
+            if (keyword == "end") {
+                current = -1;
+            } else if (keyword == "log") {
+                m_bodies[current].push_back({InstructionType::LOG, rest_of(in), false, false, -1});
+            } else if (keyword == "dom") {
+                m_bodies[current].push_back({InstructionType::DOM_UPDATE, rest_of(in), false, false, -1});
+            } else if (keyword == "await") {
+                std::string endpoint;
+                if (!(in >> endpoint)) {
+                    throw error(line_number, "await without an endpoint.");
+                }
+                m_bodies[current].push_back({InstructionType::AWAIT, endpoint, true, true, -1});
+            } else if (keyword == "raf") {
+                std::string target;
+                if (!(in >> target)) {
+                    throw error(line_number, "raf without a callback.");
+                }
+                long long target_index = index_of(target);
+                m_bodies[current].push_back({InstructionType::ANIMATION_FRAME, target, false, false, target_index});
+            } else if (keyword == "fetch") {
+                Instruction instruction = parse_request(in, true, line_number);
+                m_bodies[current].push_back(std::move(instruction));
+            } else if (keyword == "request") {
+                Instruction instruction = parse_request(in, false, line_number);
+                m_bodies[current].push_back(std::move(instruction));
+            } else {
+                throw error(line_number, "unknown instruction '" + keyword + "'.");
+            }
+        }
+
+        if (current != -1) {
+            throw error(line_number, "callback '" + m_names[current] + "' is missing its 'end'.");
+        }
+        for (std::size_t i = 0; i < m_defined.size(); ++i) {
+            if (!m_defined[i]) {
+                throw std::runtime_error("Scenario references undefined callback '" + m_names[i] + "'.");
+            }
+        }
+    }
+
+    /**
+     * @brief Opens and parses a scenario file.
+     * @throws std::runtime_error if the file cannot be opened or is malformed.
+     */
+    static ScenarioLoader from_file(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Cannot open scenario file: " + path);
+        }
+        return ScenarioLoader(file);
+    }
+
+    /** @return The number of callbacks defined by the scenario. */
+    std::size_t callback_count() const { return m_bodies.size(); }
+
+    /**
+     * @brief Bulk-registers every callback in the heap and resolves the injection schedule.
+     *        The loader's callback bodies are moved into the heap, so this can only be called once.
+     * @return The scheduled injections ordered by offset (ties keep file order), with absolute callback IDs.
+     */
+    std::vector<ScenarioInjection> load(ClosureHeap& closure_heap) {
+        long long base = closure_heap.register_callbacks(std::move(m_bodies));
+        m_bodies.clear();
+        for (auto& injection : m_injections) {
+            injection.callback_id += base;
+        }
+        std::stable_sort(m_injections.begin(), m_injections.end(),
+            [](const ScenarioInjection& a, const ScenarioInjection& b) { return a.at_ms < b.at_ms; });
+        return std::move(m_injections);
+    }
+};
@@ -3,6 +3,10 @@
 #include <string>
 #include <any>
 #include <atomic> // Required for the thread-safe unique ID generator
+#include <memory> // For the shared ownership of suspended async frames
+#include <chrono> // For the hand-off timestamp
+
+struct AsyncFrame; // Defined in Callback.h; tasks only carry a pointer to it.
 
 /**
  * @enum TaskSource
@@ -56,6 +60,17 @@ struct Task {
     bool is_promise;        // A flag indicating if the task is the result of a promise resolution.
     std::any data;          // A type-safe container for any associated data (the payload).
 
+    // The suspended async function waiting for this task, if any. When set, the EventLoop resumes
+    // this frame instead of looking `callback_id` up in the ClosureHeap.
+    std::shared_ptr<AsyncFrame> resume_frame;
+
+    // When the Scheduler handed this task to the EventLoop; used to measure the hand-off latency.
+    std::chrono::steady_clock::time_point routed_at;
+
+    // Set for fresh events injected from the outside world. Only these may be shed to make room
+    // under load; completed API responses and suspended frames are already admitted work.
+    bool sheddable = false;
+
     /**
      * @brief Generates a new, unique ID in a thread-safe manner.
      * @return A unique long long identifier.
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "Task.h"
+#include "Callback.h"
+#include <fstream>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <any>
+#include <algorithm>
+
+/**
+ * @enum LogEventKind
+ * @brief Identifies the kind of record stored in a replay log.
+ *
+ * The explicit underlying values are part of the on-disk format and must never be renumbered.
+ */
+enum class LogEventKind : std::uint8_t {
+    CALLBACK_REGISTERED = 1, // A Callback was registered in the ClosureHeap by the injecting code.
+    TASK_INJECTED       = 2, // A Task was pushed into the Scheduler from outside the engine.
+    API_RESPONSE        = 3, // An API worker completed a request (response payload + observed latency).
+    END                 = 4  // The recording was closed; its offset marks the end of the session.
+};
+
+/**
+ * @struct LogEvent
+ * @brief A single decoded record from a replay log.
+ *
+ * Only the members relevant to `kind` are meaningful; the rest stay default-constructed.
+ */
+struct LogEvent {
+    LogEventKind kind;
+    std::uint64_t offset_us;        // Microseconds elapsed since injection started (0 for records written before).
+
+    Callback callback;              // CALLBACK_REGISTERED
+    Task task;                      // TASK_INJECTED
+
+    std::uint64_t api_ordinal = 0;  // API_RESPONSE: the n-th request launched by the ApiManager.
+    std::uint64_t api_latency_us = 0;
+    std::string api_data;
+};
+
+/**
+ * @class TaskRecorder
+ * @brief Writes every externally injected Task, Callback registration and API response to a compact binary log.
+ *
+ * The log starts with a small header (magic, format version and the ClosureHeap seed) followed by
+ * a flat sequence of records. Each record is prefixed by its kind and a timestamp relative to
+ * start(), the moment the session begins injecting tasks, which is what allows a replay to
+ * reproduce the original timing. Records written before start() (e.g., while a scenario loads)
+ * are stamped 0.
+ *
+ * Every task and API response record is flushed as soon as it is written, together with the
+ * callbacks before it, so a session that is killed or crashes still leaves a replayable log.
+ * All methods are thread-safe: the main thread records injections while the ApiManager records responses.
+ */
+class TaskRecorder {
+private:
+    std::ofstream m_out;
+    std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_start;
+    bool m_closed = false;
+
+    bool m_started = false;
+
+    std::uint64_t elapsed_us() const {
+        if (!m_started) {
+            return 0;
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    template <typename T>
+    void write_pod(T value) {
+        m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write_string(const std::string& value) {
+        write_pod<std::uint32_t>(static_cast<std::uint32_t>(value.size()));
+        m_out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    void write_header(LogEventKind kind) {
+        write_pod<std::uint8_t>(static_cast<std::uint8_t>(kind));
+        write_pod<std::uint64_t>(elapsed_us());
+    }
+
+public:
+    static constexpr char MAGIC[4] = {'J', 'S', 'R', 'L'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    /**
+     * @brief Opens the log file and writes its header.
+     * @param path The file to create (truncated if it already exists).
+     * @param seed The seed used by the ClosureHeap, stored so a replay can reproduce closure IDs.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    TaskRecorder(const std::string& path, std::uint64_t seed)
+        : m_out(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!m_out) {
+            throw std::runtime_error("Cannot open replay log for writing: " + path);
+        }
+        m_out.write(MAGIC, sizeof(MAGIC));
+        write_pod<std::uint32_t>(VERSION);
+        write_pod<std::uint64_t>(seed);
+        m_out.flush();
+    }
+
+    // The recorder owns a file stream and a timeline origin; sharing it by copy makes no sense.
+    TaskRecorder(const TaskRecorder&) = delete;
+    TaskRecorder& operator=(const TaskRecorder&) = delete;
+
+    ~TaskRecorder() {
+        close();
+    }
+
+    /**
+     * @brief Starts the recording's timeline. Call it right before the first task is injected, so
+     *        that engine start-up and scenario loading are not replayed as idle time.
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_start = std::chrono::steady_clock::now();
+        m_started = true;
+    }
+
+    /**
+     * @brief Records the registration of a Callback, including its full instruction list.
+     */
+    void record_callback(const Callback& callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) return;
+        write_header(LogEventKind::CALLBACK_REGISTERED);
+        write_pod<std::int64_t>(callback.id);
+        write_pod<std::uint32_t>(static_cast<std::uint32_t>(callback.instructions.size()));
+        for (const auto& instruction : callback.instructions) {
+            write_pod<std::uint8_t>(static_cast<std::uint8_t>(instruction.type));
+            write_string(instruction.payload);
+            write_pod<std::uint8_t>(instruction.is_api_request);
+            write_pod<std::uint8_t>(instruction.is_promise);
+            write_pod<std::int64_t>(instruction.then_callback_id);
+        }
+    }
+
+    /**
+     * @brief Records a Task injected into the Scheduler from outside the engine.
+     *        Only string payloads are preserved; any other `data` type is recorded as empty.
+     */
+    void record_task(const Task& task) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) return;
+        write_header(LogEventKind::TASK_INJECTED);
+        write_pod<std::int64_t>(task.id);
+        write_pod<std::uint8_t>(static_cast<std::uint8_t>(task.source));
+        write_pod<std::uint8_t>(static_cast<std::uint8_t>(task.action));
+        write_pod<std::uint8_t>(static_cast<std::uint8_t>(task.type));
+        write_pod<std::int64_t>(task.callback_id);
+        write_pod<std::uint8_t>(task.is_promise);
+        const std::string* text = std::any_cast<std::string>(&task.data);
+        write_string(text ? *text : std::string());
+        m_out.flush();
+    }
+
+    /**
+     * @brief Records a completed API request.
+     * @param ordinal The launch order of the request inside the ApiManager (0 for the first one).
+     * @param latency_us The time between launching the worker and receiving its response.
+     * @param data The response payload.
+     */
+    void record_api_response(std::uint64_t ordinal, std::uint64_t latency_us, const std::string& data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) return;
+        write_header(LogEventKind::API_RESPONSE);
+        write_pod<std::uint64_t>(ordinal);
+        write_pod<std::uint64_t>(latency_us);
+        write_string(data);
+        m_out.flush();
+    }
+
+    /**
+     * @brief Writes the END record and flushes the log. Further record calls are ignored.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) return;
+        write_header(LogEventKind::END);
+        m_out.flush();
+        m_closed = true;
+    }
+};
+
+/**
+ * @class TaskLogReader
+ * @brief Loads a log written by TaskRecorder and decodes it into an ordered list of LogEvents.
+ *
+ * The whole file is read into memory once and decoded in a single pass, so replaying never
+ * touches the disk while the engine is running. A log whose last record was cut short (the
+ * recording session was killed) is decoded up to its last complete record.
+ */
+class TaskLogReader {
+private:
+    std::vector<char> m_buffer;
+    std::size_t m_pos = 0;
+    std::uint64_t m_seed = 0;
+    std::vector<LogEvent> m_events;
+    bool m_truncated = false;
+
+    // Thrown when a read runs past the end of the file, so a cut-off last record can be told apart from corruption.
+    struct Truncated : std::runtime_error {
+        Truncated() : std::runtime_error("Replay log is truncated.") {}
+    };
+
+    template <typename T>
+    T read_pod() {
+        if (m_pos + sizeof(T) > m_buffer.size()) {
+            throw Truncated();
+        }
+        T value;
+        std::copy(m_buffer.data() + m_pos, m_buffer.data() + m_pos + sizeof(T), reinterpret_cast<char*>(&value));
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    // Enums are stored as one byte; a value past `last` can only come from a corrupt file and must not
+    // reach the engine, which uses some of them as array indices.
+    template <typename E>
+    E read_enum(E last) {
+        std::uint8_t raw = read_pod<std::uint8_t>();
+        if (raw > static_cast<std::uint8_t>(last)) {
+            throw std::runtime_error("Replay log is corrupt: enum value out of range.");
+        }
+        return static_cast<E>(raw);
+    }
+
+    std::string read_string() {
+        std::uint32_t size = read_pod<std::uint32_t>();
+        if (m_pos + size > m_buffer.size()) {
+            throw Truncated();
+        }
+        std::string value(m_buffer.data() + m_pos, size);
+        m_pos += size;
+        return value;
+    }
+
+    // Decodes the record at the current position.
+    LogEvent read_event() {
+        LogEvent event;
+        event.kind = static_cast<LogEventKind>(read_pod<std::uint8_t>());
+        event.offset_us = read_pod<std::uint64_t>();
+
+        switch (event.kind) {
+            case LogEventKind::CALLBACK_REGISTERED: {
+                event.callback.id = read_pod<std::int64_t>();
+                std::uint32_t count = read_pod<std::uint32_t>();
+                event.callback.instructions.reserve(std::min<std::size_t>(count, m_buffer.size() - m_pos));
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    Instruction instruction;
+                    instruction.type = read_enum(InstructionType::AWAIT);
+                    instruction.payload = read_string();
+                    instruction.is_api_request = read_pod<std::uint8_t>() != 0;
+                    instruction.is_promise = read_pod<std::uint8_t>() != 0;
+                    instruction.then_callback_id = read_pod<std::int64_t>();
+                    event.callback.instructions.push_back(std::move(instruction));
+                }
+                break;
+            }
+            case LogEventKind::TASK_INJECTED:
+                event.task.id = read_pod<std::int64_t>();
+                event.task.source = read_enum(TaskSource::API_WORKER);
+                event.task.action = read_enum(TaskAction::RESPONSE);
+                event.task.type = read_enum(TaskType::MICROTASK);
+                event.task.callback_id = read_pod<std::int64_t>();
+                event.task.is_promise = read_pod<std::uint8_t>() != 0;
+                event.task.data = read_string();
+                break;
+            case LogEventKind::API_RESPONSE:
+                event.api_ordinal = read_pod<std::uint64_t>();
+                event.api_latency_us = read_pod<std::uint64_t>();
+                event.api_data = read_string();
+                break;
+            case LogEventKind::END:
+                break;
+            default:
+                throw std::runtime_error("Unknown record kind in replay log.");
+        }
+        return event;
+    }
+
+public:
+    /**
+     * @brief Reads and decodes the whole log.
+     * @param path The log file produced by a previous recording.
+     * @throws std::runtime_error if the file is missing, has a wrong or truncated header, or is corrupt.
+     */
+    explicit TaskLogReader(const std::string& path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw std::runtime_error("Cannot open replay log for reading: " + path);
+        }
+        m_buffer.resize(static_cast<std::size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+
+        char magic[4];
+        for (char& c : magic) c = read_pod<char>();
+        if (!std::equal(magic, magic + 4, TaskRecorder::MAGIC) || read_pod<std::uint32_t>() != TaskRecorder::VERSION) {
+            throw std::runtime_error("Not a replay log (or unsupported version): " + path);
+        }
+        m_seed = read_pod<std::uint64_t>();
+
+        while (m_pos < m_buffer.size()) {
+            try {
+                m_events.push_back(read_event());
+            } catch (const Truncated&) {
+                m_truncated = true; // Keep every complete record before the cut.
+                break;
+            }
+        }
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+    }
+
+    /** @return The ClosureHeap seed stored in the log header. */
+    std::uint64_t seed() const { return m_seed; }
+
+    /** @return All decoded records, in the order they were written. */
+    const std::vector<LogEvent>& events() const { return m_events; }
+
+    /** @return true if the log ended in the middle of a record, which was dropped. */
+    bool truncated() const { return m_truncated; }
+};
@@ -2,8 +2,32 @@
 
 #include <deque>
 #include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <vector>
 #include <utility> // For std::move
 
+/**
+ * @enum OverflowPolicy
+ * @brief What a bounded queue does when an item is offered while it is full.
+ */
+enum class OverflowPolicy {
+    BLOCK,       // The producer waits until a consumer makes room.
+    REJECT,      // The item is refused and handed back to the producer.
+    SHED_OLDEST  // The oldest sheddable item is dropped to make room (falls back to REJECT if there is none).
+};
+
+/**
+ * @enum PushResult
+ * @brief The outcome of TaskQueue::offer().
+ */
+enum class PushResult {
+    ACCEPTED,   // The item was enqueued.
+    REJECTED,   // The queue was full; the item was not enqueued.
+    SHED        // The item was enqueued after dropping the oldest sheddable item.
+};
+
 /**
  * @class TaskQueue
  * @brief A generic, thread-safe queue for inter-thread communication.
@@ -12,6 +36,10 @@
  * that operations like push and pop can be safely called from multiple threads
  * without causing data races. It is templated to allow storing any type of object.
  *
+ * A queue can optionally be given a capacity. The capacity is only enforced by offer(),
+ * which applies an OverflowPolicy; push_back() and push_front() always succeed, and are
+ * meant for work that has already been admitted and must not be lost (e.g., API responses).
+ *
  * @tparam T The type of elements to be stored in the queue.
  */
 template <typename T>
@@ -20,9 +48,24 @@ private:
     std::deque<T> m_tasks;
     std::mutex m_mutex;
 
+    // Maximum number of items accepted by offer(). 0 means unbounded.
+    std::size_t m_capacity;
+
+    // Signalled by pop() so that producers blocked in offer() can re-check for room.
+    std::condition_variable m_not_full;
+
+    bool is_full() const {
+        return m_capacity != 0 && m_tasks.size() >= m_capacity;
+    }
+
 public:
-    // Default constructor is sufficient.
-    TaskQueue() = default;
+    /**
+     * @brief Constructs the queue.
+     * @param capacity The maximum number of items accepted by offer(); 0 (the default) means unbounded.
+     */
+    explicit TaskQueue(std::size_t capacity = 0)
+        : m_capacity(capacity)
+    {}
 
     // A thread-safe queue manages shared state (the mutex and the deque).
     // Copying it would be ambiguous and error-prone. Deleting these operations
@@ -50,6 +93,60 @@ public:
         m_tasks.push_back(std::move(item));
     }
 
+    /**
+     * @brief Pushes a whole batch of items to the back of the queue under a single lock acquisition.
+     * @param items The items to be added, in order. They are moved into the queue.
+     */
+    void push_back_batch(std::vector<T> items) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& item : items) {
+            m_tasks.push_back(std::move(item));
+        }
+    }
+
+    /**
+     * @brief Pushes an item to the back of the queue, honouring the queue's capacity.
+     *
+     * @param item The item to be added. It is moved from only if it is enqueued.
+     * @param policy What to do if the queue is full.
+     * @param displaced Receives the item that did not make it: `item` itself when REJECTED,
+     *        or the dropped item when SHED. Left empty when ACCEPTED.
+     * @param is_sheddable For SHED_OLDEST, selects which queued items may be dropped
+     *        (all of them if empty). The oldest matching item is dropped.
+     * @return The outcome of the offer.
+     */
+    PushResult offer(T&& item, OverflowPolicy policy, std::optional<T>& displaced,
+                     const std::function<bool(const T&)>& is_sheddable = {}) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        PushResult result = PushResult::ACCEPTED;
+
+        if (is_full()) {
+            if (policy == OverflowPolicy::BLOCK) {
+                m_not_full.wait(lock, [this]() { return !is_full(); });
+            } else {
+                auto victim = m_tasks.end();
+                if (policy == OverflowPolicy::SHED_OLDEST) {
+                    for (auto it = m_tasks.begin(); it != m_tasks.end(); ++it) {
+                        if (!is_sheddable || is_sheddable(*it)) {
+                            victim = it;
+                            break;
+                        }
+                    }
+                }
+                if (victim == m_tasks.end()) {
+                    displaced = std::move(item);
+                    return PushResult::REJECTED;
+                }
+                displaced = std::move(*victim);
+                m_tasks.erase(victim);
+                result = PushResult::SHED;
+            }
+        }
+
+        m_tasks.push_back(std::move(item));
+        return result;
+    }
+
     /**
      * @brief Pops and returns the item from the front of the queue.
      * @return The front-most item. If the queue is empty, a default-constructed
@@ -62,6 +159,7 @@ public:
         }
         T item = std::move(m_tasks.front());
         m_tasks.pop_front();
+        m_not_full.notify_one();
         return item;
     }
 
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+#include <stdexcept>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @brief Returns the NUMA node a CPU belongs to, or -1 if it cannot be determined.
+ */
+inline int numaNodeOfCpu(int cpu) {
+    std::error_code ec;
+    std::filesystem::path cpu_dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    for (const auto& entry : std::filesystem::directory_iterator(cpu_dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) == 0) {
+            return std::stoi(name.substr(4));
+        }
+    }
+    return -1;
+}
+
+/**
+ * @class ThreadTuning
+ * @brief Placement settings for the engine's actor threads, and the record of what was actually applied.
+ *
+ * Each actor can be pinned to one CPU so the OS does not migrate it and the caches holding its
+ * state stay warm. On Linux a new thread inherits its creator's affinity, so actors that are not
+ * pinned explicitly are reset to the CPUs the process started with: pinning one thread never
+ * drags the others onto its core.
+ *
+ * Memory placement follows Linux's first-touch policy: pages are allocated on the NUMA node of
+ * the thread that first writes them. The main thread creates the ClosureHeap and registers every
+ * callback, so pinning it on the EventLoop's node keeps the heap local to its reader. Queue
+ * storage is allocated by whichever thread pushes (mostly the Scheduler and the ApiManager), so
+ * keeping the queues local requires pinning those actors on the same node as well.
+ */
+class ThreadTuning {
+public:
+    // Actor name (main, scheduler, api, eventloop) → requested CPU. Actors not listed are not pinned.
+    std::map<std::string, int> pinned_cpus;
+
+    // If true, the EventLoop spins on its queues instead of sleeping on its Alarm. Only makes
+    // sense when it is pinned to a dedicated core: it trades one busy CPU for lower wake-up latency.
+    bool event_loop_busy_poll = false;
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<std::string, int> m_applied; // Actor → CPU it was actually pinned to.
+#if defined(__linux__)
+    cpu_set_t m_default_cpus;             // The process's affinity before any thread was tuned.
+    bool m_has_default_cpus = false;
+#endif
+
+public:
+    /**
+     * @brief Captures the process's original CPU affinity. Must be constructed before any thread is tuned.
+     */
+    ThreadTuning() {
+#if defined(__linux__)
+        CPU_ZERO(&m_default_cpus);
+        m_has_default_cpus = sched_getaffinity(0, sizeof(m_default_cpus), &m_default_cpus) == 0;
+#endif
+    }
+
+    // Shared by reference with every actor thread, which records its outcome here.
+    ThreadTuning(const ThreadTuning&) = delete;
+    ThreadTuning& operator=(const ThreadTuning&) = delete;
+
+    /**
+     * @brief Parses a `<actor>=<cpu>` command-line argument.
+     * @throws std::invalid_argument if the actor is unknown or the CPU is not a valid index.
+     */
+    void parse_pin(const std::string& spec) {
+        std::size_t separator = spec.find('=');
+        std::string actor = spec.substr(0, separator);
+        std::string cpu = separator == std::string::npos ? std::string() : spec.substr(separator + 1);
+        bool known_actor = actor == "main" || actor == "scheduler" || actor == "api" || actor == "eventloop";
+        bool valid_cpu = !cpu.empty() && cpu.size() <= 9 && std::all_of(cpu.begin(), cpu.end(), [](unsigned char c) { return std::isdigit(c); });
+        if (!known_actor || !valid_cpu) {
+            throw std::invalid_argument("Expected --pin <main|scheduler|api|eventloop>=<cpu>, got: " + spec);
+        }
+        pinned_cpus[actor] = std::stoi(cpu);
+    }
+
+    /** @return The CPU the actor should be pinned to, or -1 if it floats. */
+    int cpu_for(const std::string& actor) const {
+        auto it = pinned_cpus.find(actor);
+        return it == pinned_cpus.end() ? -1 : it->second;
+    }
+
+    /**
+     * @brief Names the calling thread for profilers and debuggers and applies the actor's placement.
+     *
+     * Failures are reported but not fatal: an untuned thread still runs correctly.
+     *
+     * @param actor The actor whose settings apply (main, scheduler, api, eventloop).
+     * @param thread_name The thread name (at most 15 characters are kept on Linux).
+     * @param log Where to report what was applied.
+     */
+    void apply(const std::string& actor, const std::string& thread_name, std::ostream& log) {
+        int cpu = cpu_for(actor);
+#if defined(__linux__)
+        pthread_setname_np(pthread_self(), thread_name.substr(0, 15).c_str());
+        if (cpu < 0) {
+            // Undo the affinity inherited from a pinned creator thread.
+            if (m_has_default_cpus) {
+                pthread_setaffinity_np(pthread_self(), sizeof(m_default_cpus), &m_default_cpus);
+            }
+            return;
+        }
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpus);
+        }
+        if (cpu < CPU_SETSIZE && pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_applied[actor] = cpu;
+            }
+            log << "[Tuning]: Thread '" << thread_name << "' pinned to CPU " << cpu << " (NUMA node " << numaNodeOfCpu(cpu) << ")." << std::endl;
+        } else {
+            log << "[Tuning]: WARNING! Could not pin thread '" << thread_name << "' to CPU " << cpu << "; it is left unpinned." << std::endl;
+            if (m_has_default_cpus) {
+                pthread_setaffinity_np(pthread_self(), sizeof(m_default_cpus), &m_default_cpus);
+            }
+        }
+#else
+        if (cpu >= 0) {
+            log << "[Tuning]: WARNING! CPU pinning is not supported on this platform; '" << thread_name << "' is not pinned." << std::endl;
+        }
+#endif
+    }
+
+    /**
+     * @brief Prints the placement that is actually in effect (failed pins are not listed). Safe to call from any thread.
+     */
+    void report(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out << "[Tuning]: Settings:";
+        if (m_applied.empty()) {
+            out << " no pinning";
+        }
+        for (const auto& [actor, cpu] : m_applied) {
+            out << " " << actor << "=cpu" << cpu << "(node " << numaNodeOfCpu(cpu) << ")";
+        }
+        out << (event_loop_busy_poll ? ", event loop busy-polling" : ", event loop sleeping on its alarm") << "." << std::endl;
+    }
+};
+
+/**
+ * @brief Tells the CPU that the caller is spinning, which saves power and frees resources for a sibling hyper-thread.
+ */
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @class HandoffLatency
+ * @brief Measures how long tasks wait between being routed to the EventLoop and starting to execute.
+ *
+ * This is the latency that thread placement and busy polling act upon, so it is printed right
+ * after the tuning settings at the end of a benchmark run.
+ */
+class HandoffLatency {
+private:
+    mutable std::mutex m_mutex;
+    long long m_count = 0;
+    std::chrono::nanoseconds m_total{0};
+    std::chrono::nanoseconds m_max{0};
+
+public:
+    void record(std::chrono::nanoseconds latency) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_count;
+        m_total += latency;
+        if (latency > m_max) {
+            m_max = latency;
+        }
+    }
+
+    /**
+     * @brief Prints the latency statistics. Safe to call from any thread.
+     */
+    void report(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::chrono::nanoseconds average = m_count ? std::chrono::nanoseconds(m_total / m_count) : std::chrono::nanoseconds(0);
+        out << "[Tuning]: Scheduler→EventLoop hand-off latency over " << m_count << " tasks: avg "
+            << std::chrono::duration_cast<std::chrono::microseconds>(average).count() << " us, max "
+            << std::chrono::duration_cast<std::chrono::microseconds>(m_max).count() << " us." << std::endl;
+    }
+};
@@ -14,11 +14,79 @@
 #include <condition_variable>
 #include <random>
 #include <limits>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
 
 #include "Task.h"
 #include "ClosureHeap.h"
 #include "Alarm.h"
 #include "TaskQueue.h"
+#include "TaskLog.h"
+#include "ScenarioLoader.h"
+#include "FrameRenderer.h"
+#include "AdmissionController.h"
+#include "IoReactor.h"
+#include "ThreadTuning.h"
+
+// ===================================================================
+// == TASK INJECTION
+// ===================================================================
+
+/**
+ * @brief Pushes a Task into the engine from the outside world (the control panel or a replay).
+ *
+ * Every externally injected task goes through here so that it is counted as in-flight work,
+ * subjected to admission control and, when the engine runs in record mode, captured in the replay log.
+ *
+ * @param task The task to inject.
+ * @param sched_q The Scheduler's queue.
+ * @param sched_alarm The Scheduler's alarm, notified after the push.
+ * @param admission The admission controller that applies the overflow policy if the Scheduler's queue is full.
+ * @param tasks_in_flight Counter of tasks that have entered the engine but whose callback has not run yet.
+ * @param recorder The active recorder, or nullptr when not recording.
+ * @return The admission outcome. REJECTED means the task never entered the engine.
+ */
+PushResult injectTask(Task task, TaskQueue<Task>& sched_q, Alarm& sched_alarm, AdmissionController& admission, std::atomic<long long>& tasks_in_flight, TaskRecorder* recorder) {
+    if (recorder) {
+        recorder->record_task(task);
+    }
+    // Fresh external events are the only tasks that may later be shed in favour of newer ones.
+    task.sheddable = true;
+    // Counted before the offer: if it is rejected, the admission error callback takes it back out.
+    tasks_in_flight.fetch_add(1, std::memory_order_relaxed);
+    PushResult result = admission.admit(std::move(task), sched_q);
+    if (result != PushResult::REJECTED) {
+        sched_alarm.notify();
+    }
+    return result;
+}
+
+/**
+ * @brief Prints the outcome of an injection made from the control panel, a replay or a scenario.
+ */
+void reportAdmission(PushResult result) {
+    if (result == PushResult::REJECTED) {
+        std::cout << "[MAIN]: Injection REJECTED: the Scheduler's queue is full." << std::endl;
+    } else if (result == PushResult::SHED) {
+        std::cout << "[MAIN]: Injection accepted, but an older task of the same kind was shed to make room." << std::endl;
+    }
+}
+
+/**
+ * @brief Blocks the calling thread until every in-flight task has been executed and the last frame rendered.
+ *        Used by the non-interactive modes (replay, scenario) to know when a run is over.
+ */
+void waitUntilDrained(const std::atomic<long long>& tasks_in_flight, const FrameRenderer& renderer) {
+    // Acquire pairs with the release decrement in the EventLoop, so any frame armed by the
+    // last task is visible here before the counter is seen at zero.
+    while (tasks_in_flight.load(std::memory_order_acquire) > 0 || renderer.frame_pending()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
 
 // ===================================================================
 // == INTERACTIVE SIMULATION FUNCTIONS
@@ -29,7 +97,7 @@
  * This function sets up the entire chain of callbacks and injects the initial
  * task into the engine to kick off the process.
  */
-void simulateFetchThen(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm& sched_alarm) {
+void simulateFetchThen(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm& sched_alarm, AdmissionController& admission, std::atomic<long long>& tasks_in_flight, TaskRecorder* recorder) {
     std::cout << "\n[MAIN]: === SIMULATION: Chained Promise (fetch.then) ===" << std::endl;
 
     // STEP 1: Define the terminal callback (`.then()` clause of the second promise).
@@ -52,12 +120,12 @@ void simulateFetchThen(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm&
     first_promise_task.id = Task::generate_id();
     first_promise_task.source = TaskSource::API_WORKER;
     first_promise_task.action = TaskAction::RESPONSE;
+    first_promise_task.type = TaskType::MICROTASK;
     first_promise_task.callback_id = initial_cb_id;
     first_promise_task.is_promise = true;
     first_promise_task.data = std::string("Initial API response data");
 
-    sched_q.push_back(std::move(first_promise_task));
-    sched_alarm.notify();
+    reportAdmission(injectTask(std::move(first_promise_task), sched_q, sched_alarm, admission, tasks_in_flight, recorder));
     std::cout << "[MAIN]: =================================================\n" << std::endl;
 }
 
@@ -66,7 +134,7 @@ void simulateFetchThen(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm&
  * This function demonstrates the macrotask pathway. The task is not a promise and
  * will be executed by the Event Loop only after any pending microtasks are cleared.
  */
-void simulateDomClick(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm& sched_alarm) {
+void simulateDomClick(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm& sched_alarm, AdmissionController& admission, std::atomic<long long>& tasks_in_flight, TaskRecorder* recorder) {
     std::cout << "\n[MAIN]: === SIMULATION: DOM Click Event (Macrotask) ===" << std::endl;
 
     // STEP 1: Define the 'onclick' event handler.
@@ -87,8 +155,7 @@ void simulateDomClick(ClosureHeap& cb_manager, TaskQueue<Task>& sched_q, Alarm&
     dom_event_task.data = std::string("{\"type\":\"click\", \"target\":\"#submit-btn\"}");
 
     // STEP 3: Inject the task and notify the Scheduler.
-    sched_q.push_back(std::move(dom_event_task));
-    sched_alarm.notify();
+    reportAdmission(injectTask(std::move(dom_event_task), sched_q, sched_alarm, admission, tasks_in_flight, recorder));
     std::cout << "[MAIN]: =============================================\n" << std::endl;
 }
 
@@ -106,53 +173,59 @@ struct ApiResponse {
     std::any data;
 };
 
+// Describes how a simulated API behaves: how long it takes and what it answers.
+// Live runs use the defaults; a replay feeds back the latency and payload that were recorded.
+struct ApiWorkerScript {
+    std::chrono::microseconds latency = std::chrono::seconds(2);
+    std::string response_data = "{\"message\":\"API data received successfully\"}";
+};
+
 
 /**
- * @brief Simulates sending a request to an external API.
+ * @brief Simulates the external API answering a request once its latency has elapsed.
  *
- * This function launches a new "fire-and-forget" thread to simulate a non-blocking
- * network operation. Upon completion, the worker thread places the response in the
- * ApiManager's response queue and notifies it to wake up and process the result.
+ * Only the ApiRequest crosses into the "outside world"; the engine's Task stays with the ApiManager.
  *
  * @param request The request object containing the data for the API call.
- * @param response_queue A reference to the queue where the worker must place the response.
- * @param api_manager_alarm A reference to the ApiManager's alarm to notify it upon completion.
+ * @param script The simulated response payload for this request.
+ * @return The response to hand back to the ApiManager.
  */
-void sendAPIRequest( ApiRequest request, TaskQueue<ApiResponse>& response_queue, Alarm& api_manager_alarm) {
-    // Launch the work in a new thread to avoid blocking the ApiManager.
-    std::thread worker_thread(
-        // The lambda that contains the code to be executed in the new thread.
-        [](ApiRequest req, TaskQueue<ApiResponse>& resp_q, Alarm& alarm) {
-            
-            std::cout << "    [API Worker " << req.task_id << "]: Request received. Starting simulated work..." << std::endl;
-
-            // Simulate network latency.
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-
-            // Prepare the response.
-            ApiResponse response;
-            response.task_id = req.task_id;
-            response.data = std::string("{\"message\":\"API data received successfully\"}");
-
-            std::cout << "    [API Worker " << req.task_id << "]: Work complete. Enqueuing response..." << std::endl;
-
-            // Push the ApiResponse into the ApiManager's queue.
-            resp_q.push_back(response);
-
-            // Notify the ApiManager in case it's sleeping.
-            alarm.notify();
+ApiResponse completeAPIRequest(const ApiRequest& request, ApiWorkerScript script) {
+    std::cout << "    [API " << request.task_id << "]: Work complete. Enqueuing response..." << std::endl;
+    ApiResponse response;
+    response.task_id = request.task_id;
+    response.data = std::move(script.response_data);
+    return response;
+}
 
-            // The thread terminates here, and its resources are released.
-        },
-        //We pass the args to the lamda functions
-        std::move(request),             // Move the request to transfer ownership.
-        std::ref(response_queue),       // Pass the queue by reference.
-        std::ref(api_manager_alarm)     // Pass the alarm by reference.
-    );
+// The value an API request evaluates to when admission control rejects it, like the reason of a rejected promise.
+const std::string REQUEST_REJECTED_ERROR = "Error: request rejected, the Scheduler's queue is full";
 
-    // .detach() allows the thread to run independently.
-    // The ApiManager does not need to wait (join()) for it to finish.
-    worker_thread.detach();
+/**
+ * @brief Replaces every `$n` in an instruction payload with the frame's n-th local.
+ *        References to locals that do not exist (yet) are left untouched.
+ */
+std::string expandLocals(const std::string& payload, const std::vector<std::any>& locals) {
+    std::string expanded;
+    std::size_t i = 0;
+    while (i < payload.size()) {
+        std::size_t digits_end = i + 1;
+        while (digits_end < payload.size() && std::isdigit(static_cast<unsigned char>(payload[digits_end]))) {
+            ++digits_end;
+        }
+        // Indices are capped at 9 digits, so the conversion cannot overflow.
+        std::size_t index = payload[i] == '$' && digits_end > i + 1 && digits_end - i <= 10
+            ? std::stoul(payload.substr(i + 1, digits_end - i - 1))
+            : locals.size();
+        if (index >= locals.size()) {
+            expanded += payload[i++];
+            continue;
+        }
+        const std::string* text = std::any_cast<std::string>(&locals[index]);
+        expanded += text ? *text : std::string("<non-printable>");
+        i = digits_end;
+    }
+    return expanded;
 }
 
 /**
@@ -162,15 +235,30 @@ void sendAPIRequest( ApiRequest request, TaskQueue<ApiResponse>& response_queue,
  * instructions from a Callback and performs actions based on them, such as
  * logging messages or creating new tasks for the Scheduler.
  *
- * @param callback The Callback object containing the instructions to execute.
- * @param data The input data for this execution (e.g., the response from an API).
+ * Execution starts at `frame.ip`, so the same function both starts a callback (ip 0) and
+ * resumes one that was suspended by an AWAIT instruction.
+ *
+ * @param frame The execution state: the Callback to run and the instruction to start from.
+ * @param data The input data for this execution (e.g., the response from an API, or the awaited value when resuming).
+ *             It becomes the frame's next local, so `$0` is the original argument and `$n` the n-th awaited value.
  * @param closure_heap Reference to the Closure Heap to register new functions.
  * @param scheduler_queue Reference to the Scheduler's queue to send new tasks.
  * @param scheduler_alarm Reference to the Scheduler's alarm to wake it up.
+ * @param admission The admission controller; tasks created here shed a fresh external macrotask, or are rejected (never blocked), if the Scheduler is full.
+ * @param tasks_in_flight Counter of in-flight tasks, incremented for every task created here.
+ * @param renderer The render phase, which receives DOM updates and animation frame requests.
+ * @param microtask_queue The EventLoop's own microtask queue, which receives the error continuation of a rejected promise request.
+ * @param macrotask_queue The EventLoop's own macrotask queue, which receives the error continuation of a rejected macrotask request.
  */
-void executeStackJS( Callback callback, const std::any& data, ClosureHeap& closure_heap, TaskQueue<Task>& scheduler_queue, Alarm& scheduler_alarm) 
+void executeStackJS( AsyncFrame frame, const std::any& data, ClosureHeap& closure_heap, TaskQueue<Task>& scheduler_queue, Alarm& scheduler_alarm, AdmissionController& admission, std::atomic<long long>& tasks_in_flight, FrameRenderer& renderer, TaskQueue<Task>& microtask_queue, TaskQueue<Task>& macrotask_queue) 
 {
-    std::cout << "  [EventLoop::executeStackJS] >>>> STARTING EXECUTION OF CALLBACK ID: " << callback.id << std::endl;
+    const Callback& callback = frame.callback;
+    const bool resumed = frame.ip > 0;
+    if (!resumed) {
+        std::cout << "  [EventLoop::executeStackJS] >>>> STARTING EXECUTION OF CALLBACK ID: " << callback.id << std::endl;
+    } else {
+        std::cout << "  [EventLoop::executeStackJS] >>>> RESUMING CALLBACK ID: " << callback.id << " at instruction " << frame.ip << std::endl;
+    }
 
     // Print the data received by the task, if any.
     try {
@@ -182,9 +270,48 @@ void executeStackJS( Callback callback, const std::any& data, ClosureHeap& closu
         std::cout << "  [EventLoop::executeStackJS] Received data of a non-printable type." << std::endl;
     }
 
+    frame.locals.push_back(data);
+
     // Iterate and "interpret" each instruction within the callback.
-    for (const auto& instruction : callback.instructions) {
-        std::cout << "  [EventLoop::executeStackJS] Executing instruction: " << instruction.payload << std::endl;
+    for (; frame.ip < callback.instructions.size(); ++frame.ip) {
+        const Instruction& instruction = callback.instructions[frame.ip];
+        const std::string payload = expandLocals(instruction.payload, frame.locals);
+        std::cout << "  [EventLoop::executeStackJS] Executing instruction: " << payload << std::endl;
+
+        if (instruction.type == InstructionType::AWAIT) {
+            // Suspend: the frame (positioned after the AWAIT) travels with the API request,
+            // and the response resumes it as a microtask, like a resolved promise.
+            Task await_task;
+            await_task.id = Task::generate_id();
+            await_task.source = TaskSource::EVENT_LOOP;
+            await_task.action = TaskAction::REQUEST;
+            await_task.type = TaskType::MICROTASK;
+            await_task.callback_id = callback.id;
+            await_task.is_promise = true;
+            await_task.data = payload; // e.g., The URL/endpoint for the API.
+
+            ++frame.ip;
+            std::shared_ptr<AsyncFrame> suspended = std::make_shared<AsyncFrame>(std::move(frame));
+            await_task.resume_frame = suspended;
+
+            std::cout << "  [EventLoop::executeStackJS] AWAIT: suspending callback (Task ID " << await_task.id << "). Dispatching to Scheduler." << std::endl;
+            // Once admitted, the frame belongs to the task and may already be resumed elsewhere: copy the ID first.
+            long long suspended_callback_id = await_task.callback_id;
+            tasks_in_flight.fetch_add(1, std::memory_order_relaxed);
+            if (admission.admit(std::move(await_task), scheduler_queue) != PushResult::REJECTED) {
+                scheduler_alarm.notify();
+                std::cout << "  [EventLoop::executeStackJS] <<<< SUSPENDED EXECUTION OF CALLBACK ID: " << suspended_callback_id << std::endl;
+                return;
+            }
+
+            // The request never left the engine. Like a rejected promise, the await evaluates to an
+            // error value and the function goes on, instead of its frame being silently abandoned.
+            frame = std::move(*suspended);
+            frame.locals.push_back(std::any(REQUEST_REJECTED_ERROR));
+            std::cout << "  [EventLoop::executeStackJS] AWAIT rejected: resuming callback " << suspended_callback_id << " with an error value." << std::endl;
+            --frame.ip; // The loop's increment moves past the AWAIT again.
+            continue;
+        }
 
         // If the instruction is an API request, we need to generate a new Task.
         if (instruction.is_api_request) {
@@ -205,43 +332,301 @@ void executeStackJS( Callback callback, const std::any& data, ClosureHeap& closu
             api_request_task.type = instruction.is_promise ? TaskType::MICROTASK : TaskType::MACROTASK;
             api_request_task.callback_id = response_callback_id; // <- The ID of the response callback.
             api_request_task.is_promise = instruction.is_promise;
-            api_request_task.data = instruction.payload; // e.g., The URL/endpoint for the API.
+            api_request_task.data = payload; // e.g., The URL/endpoint for the API.
 
             std::cout << "  [EventLoop::executeStackJS] Task (ID " << api_request_task.id << ") created. Dispatching to Scheduler." << std::endl;
 
             // 4. Enqueue the task in the Scheduler's queue and notify it.
-            scheduler_queue.push_back(api_request_task);
-            scheduler_alarm.notify();
+            tasks_in_flight.fetch_add(1, std::memory_order_relaxed);
+            if (admission.admit(std::move(api_request_task), scheduler_queue) != PushResult::REJECTED) {
+                scheduler_alarm.notify();
+            } else if (response_callback_id != -1) {
+                // The request never left the engine. Like a rejected promise, its continuation still runs,
+                // with an error value. It goes straight to the EventLoop's own queue, past the capacity
+                // bound: the EventLoop must never wait, and the continuation replaces work already admitted.
+                std::cout << "  [EventLoop::executeStackJS] API request rejected: scheduling callback " << response_callback_id << " with an error value." << std::endl;
+                Task rejection_task;
+                rejection_task.id = Task::generate_id();
+                rejection_task.source = TaskSource::EVENT_LOOP;
+                rejection_task.action = TaskAction::RESPONSE;
+                rejection_task.type = instruction.is_promise ? TaskType::MICROTASK : TaskType::MACROTASK;
+                rejection_task.callback_id = response_callback_id;
+                rejection_task.is_promise = instruction.is_promise;
+                rejection_task.data = REQUEST_REJECTED_ERROR;
+                rejection_task.routed_at = std::chrono::steady_clock::now();
+                tasks_in_flight.fetch_add(1, std::memory_order_relaxed);
+                (instruction.is_promise ? microtask_queue : macrotask_queue).push_back(std::move(rejection_task));
+            }
+
+        } else if (instruction.type == InstructionType::DOM_UPDATE) {
+            // DOM writes are not applied here: they join the current frame's batch.
+            if (renderer.enabled()) {
+                renderer.queue_dom_update(payload);
+            } else {
+                std::cout << "  [EventLoop::executeStackJS] Render phase disabled. DOM update applied immediately: " << payload << std::endl;
+            }
+
+        } else if (instruction.type == InstructionType::ANIMATION_FRAME) {
+            if (renderer.enabled() && instruction.then_callback_id != -1) {
+                std::cout << "  [EventLoop::executeStackJS] requestAnimationFrame: callback " << instruction.then_callback_id << " scheduled for the next frame." << std::endl;
+                // Pending animation frames are in-flight work: a run is not over until they have executed.
+                tasks_in_flight.fetch_add(1, std::memory_order_relaxed);
+                renderer.request_animation_frame(instruction.then_callback_id);
+            } else {
+                std::cout << "  [EventLoop::executeStackJS] WARNING: requestAnimationFrame ignored (render phase disabled or no callback)." << std::endl;
+            }
         }
     }
 
     std::cout << "  [EventLoop::executeStackJS] <<<< FINISHED EXECUTION OF CALLBACK ID: " << callback.id << std::endl;
 }
 
-int main() {
+/**
+ * @brief Parses a non-negative integer command-line value.
+ * @throws std::invalid_argument if `text` is not entirely a non-negative number.
+ * @throws std::out_of_range if it does not fit in an unsigned long.
+ */
+unsigned long parseCount(const std::string& option, const std::string& text) {
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        throw std::invalid_argument(option + " expects a non-negative number, got: " + text);
+    }
+    try {
+        return std::stoul(text);
+    } catch (const std::out_of_range&) {
+        throw std::out_of_range(option + " value is too large: " + text);
+    }
+}
+
+/**
+ * @struct QueueCapacities
+ * @brief The bound of each queue that admits new work, and of the ApiManager's in-flight requests. 0 means unbounded.
+ */
+struct QueueCapacities {
+    std::size_t scheduler = 0;  // The Scheduler's queue, guarded by the AdmissionController.
+    std::size_t macro = 0;      // The EventLoop's macrotask queue.
+    std::size_t micro = 0;      // The EventLoop's microtask queue.
+    std::size_t api = 0;        // The ApiManager's request queue.
+    std::size_t in_flight = 0;  // Requests the ApiManager keeps in flight at once; the rest wait in its request queue.
+};
+
+/**
+ * @brief Parses a `--queue-capacity` value: a comma-separated list of `<queue>=<n>` items, where a
+ *        bare `<n>` sets the scheduler, macro, micro and api queues at once (but not `inflight`).
+ * @throws std::invalid_argument for unknown queue names or malformed numbers.
+ */
+void parseQueueCapacities(const std::string& option, const std::string& spec, QueueCapacities& capacities) {
+    std::size_t begin = 0;
+    while (begin <= spec.size()) {
+        std::size_t end = spec.find(',', begin);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        std::string item = spec.substr(begin, end - begin);
+        std::size_t separator = item.find('=');
+        if (separator == std::string::npos) {
+            std::size_t capacity = parseCount(option, item);
+            capacities.scheduler = capacities.macro = capacities.micro = capacities.api = capacity;
+        } else {
+            std::string queue = item.substr(0, separator);
+            std::size_t capacity = parseCount(option, item.substr(separator + 1));
+            if (queue == "scheduler")     capacities.scheduler = capacity;
+            else if (queue == "macro")    capacities.macro = capacity;
+            else if (queue == "micro")    capacities.micro = capacity;
+            else if (queue == "api")      capacities.api = capacity;
+            else if (queue == "inflight") capacities.in_flight = capacity;
+            else throw std::invalid_argument(option + " expects <n> or <scheduler|macro|micro|api|inflight>=<n>, got: " + item);
+        }
+        begin = end + 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "[Scheduler/Main]: Initializing engine..." << std::endl;
 
+    // Command-line options:
+    //   --record <file>  Capture every injected task, callback and API response into a binary log.
+    //   --replay <file>  Feed a recorded log back into the engine instead of the control panel.
+    //   --fast           With --replay, ignore the recorded timing and run as fast as possible.
+    //   --scenario <file> Load callbacks and an injection schedule from a scenario file (see ScenarioLoader.h).
+    //   --fps <n>        Frame rate of the EventLoop's render phase (default 60, 0 disables it).
+    //   --queue-capacity <spec>    Bound the Scheduler, EventLoop and ApiManager request queues (default 0 = unbounded):
+    //                              <n> for all four, or a list such as scheduler=<n>,macro=<n>,micro=<n>,api=<n>,inflight=<n>.
+    //   --macro-overflow <policy>  What to do with external macrotasks when the Scheduler is full: block, reject or shed (default shed).
+    //   --micro-overflow <policy>  Same for external microtasks (default block).
+    //   --pin <actor>=<cpu>        Pin an actor thread (main, scheduler, api, eventloop) to a CPU. Repeatable.
+    //   --busy-poll                Make the EventLoop spin instead of sleeping (pin it to a dedicated core).
+    std::string record_path;
+    std::string replay_path;
+    std::string scenario_path;
+    bool replay_fast = false;
+    unsigned frames_per_second = 60;
+    QueueCapacities queue_capacities;
+    OverflowPolicy macro_overflow = OverflowPolicy::SHED_OLDEST;
+    OverflowPolicy micro_overflow = OverflowPolicy::BLOCK;
+    ThreadTuning tuning;
+    // Invalid option values are reported here, before anything has been allocated or launched.
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--record" && i + 1 < argc) {
+                record_path = argv[++i];
+            } else if (arg == "--replay" && i + 1 < argc) {
+                replay_path = argv[++i];
+            } else if (arg == "--scenario" && i + 1 < argc) {
+                scenario_path = argv[++i];
+            } else if (arg == "--fast") {
+                replay_fast = true;
+            } else if (arg == "--fps" && i + 1 < argc) {
+                unsigned long fps = parseCount(arg, argv[++i]);
+                if (fps > 1000) {
+                    throw std::out_of_range("--fps must be at most 1000, got: " + std::to_string(fps));
+                }
+                frames_per_second = static_cast<unsigned>(fps);
+            } else if (arg == "--queue-capacity" && i + 1 < argc) {
+                parseQueueCapacities(arg, argv[++i], queue_capacities);
+            } else if (arg == "--macro-overflow" && i + 1 < argc) {
+                macro_overflow = AdmissionController::parse_policy(argv[++i]);
+            } else if (arg == "--micro-overflow" && i + 1 < argc) {
+                micro_overflow = AdmissionController::parse_policy(argv[++i]);
+            } else if (arg == "--pin" && i + 1 < argc) {
+                tuning.parse_pin(argv[++i]);
+            } else if (arg == "--busy-poll") {
+                tuning.event_loop_busy_poll = true;
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--record <file>] [--replay <file> [--fast] | --scenario <file>] [--fps <n>] [--queue-capacity <spec> [--macro-overflow <policy>] [--micro-overflow <policy>]] [--pin <actor>=<cpu>]... [--busy-poll]" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::logic_error& e) { // std::invalid_argument and std::out_of_range.
+        std::cerr << "[Scheduler/Main]: Invalid option: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!replay_path.empty() && !scenario_path.empty()) {
+        std::cerr << "--replay and --scenario cannot be combined." << std::endl;
+        return 1;
+    }
+    if (!replay_path.empty() && !record_path.empty()) {
+        // A replay injects the log's tasks directly; re-recording them would only duplicate the input log.
+        std::cerr << "--replay and --record cannot be combined." << std::endl;
+        return 1;
+    }
+    if (tuning.event_loop_busy_poll && tuning.cpu_for("eventloop") < 0) {
+        std::cerr << "[Scheduler/Main]: WARNING! --busy-poll without --pin eventloop=<cpu>: the EventLoop will compete with the other threads for its core." << std::endl;
+    }
+
+    // The main thread is tuned before anything is allocated: it creates the ClosureHeap and registers
+    // every callback, and Linux places pages on the NUMA node of the thread that first touches them.
+    // Pinning it next to the EventLoop keeps the heap local to the thread that reads it. The actor
+    // threads launched later do not inherit this pin (see ThreadTuning::apply()).
+    tuning.apply("main", "js-main", std::cout);
+
+    // In replay mode the log is decoded up front; its header provides the ClosureHeap seed
+    // so that closure IDs are identical to the recorded session.
+    std::unique_ptr<TaskLogReader> replay_log;
+    if (!replay_path.empty()) {
+        try {
+            replay_log = std::make_unique<TaskLogReader>(replay_path);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "[Scheduler/Main]: " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "[Scheduler/Main]: Replay log loaded (" << replay_log->events().size() << " records)." << std::endl;
+        if (replay_log->truncated()) {
+            std::cerr << "[Scheduler/Main]: WARNING! The replay log ends in the middle of a record (the recording was interrupted). Replaying every complete record." << std::endl;
+        }
+    }
+
     // The ClosureHeap serves as the engine's central memory space, simulating the Heap
     // in a real JavaScript runtime. Its role is to store all function definitions (Callback objects)
     // so they persist beyond the execution scope that creates them. This provides the critical
     // decoupling between a `Task` (a transient message carrying a callback_id) and the `Callback`
     // (the persistent logic to be executed). Essentially, it's the source of truth for all
     // executable logic in the engine.
-    ClosureHeap closure_heap;
+    ClosureHeap closure_heap = replay_log ? ClosureHeap(replay_log->seed()) : ClosureHeap();
+
+    std::unique_ptr<TaskRecorder> recorder;
+    if (!record_path.empty()) {
+        try {
+            recorder = std::make_unique<TaskRecorder>(record_path, closure_heap.seed());
+        } catch (const std::runtime_error& e) {
+            std::cerr << "[Scheduler/Main]: " << e.what() << std::endl;
+            return 1;
+        }
+        closure_heap.set_on_register([&](const Callback& cb) { recorder->record_callback(cb); });
+        std::cout << "[Scheduler/Main]: Recording session to " << record_path << std::endl;
+    }
+
+    // A scenario is streamed and parsed once and bulk-loaded into the ClosureHeap in a single call,
+    // before any actor thread exists, so a malformed file is reported instead of tearing down a running engine.
+    std::vector<ScenarioInjection> scenario_schedule;
+    if (!scenario_path.empty()) {
+        auto load_start = std::chrono::steady_clock::now();
+        std::size_t callback_count = 0;
+        try {
+            ScenarioLoader scenario = ScenarioLoader::from_file(scenario_path);
+            callback_count = scenario.callback_count();
+            scenario_schedule = scenario.load(closure_heap);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "[Scheduler/Main]: " << e.what() << std::endl;
+            return 1;
+        }
+        auto load_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - load_start);
+        std::cout << "[Scheduler/Main]: Scenario loaded: " << callback_count << " callbacks and " << scenario_schedule.size()
+                  << " injections in " << load_elapsed.count() << " us." << std::endl;
+    }
+
+    // Number of tasks that have entered the engine and whose callback has not finished executing yet.
+    // An API request and the response it turns into are the same task, so they count once.
+    // When it drops back to zero the engine is idle, which is how a replay knows it is done.
+    std::atomic<long long> tasks_in_flight(0);
+
+    // The EventLoop's render phase: requestAnimationFrame callbacks, batched DOM updates and jank statistics.
+    FrameRenderer renderer(frames_per_second);
+
+    // Recorded API responses, indexed by the launch order of their request inside the ApiManager.
+    std::vector<ApiWorkerScript> replay_api_scripts;
+    if (replay_log) {
+        for (const auto& event : replay_log->events()) {
+            if (event.kind != LogEventKind::API_RESPONSE) continue;
+            if (event.api_ordinal >= replay_api_scripts.size()) {
+                replay_api_scripts.resize(event.api_ordinal + 1);
+            }
+            ApiWorkerScript& script = replay_api_scripts[event.api_ordinal];
+            script.latency = replay_fast ? std::chrono::microseconds(0) : std::chrono::microseconds(event.api_latency_us);
+            script.response_data = event.api_data;
+        }
+    }
 
     // 1. Create the necessary communication queues for inter-thread messaging.
-    TaskQueue<Task> scheduler_queue;
-    TaskQueue<Task> api_manager_request_queue;
+    // Every queue that admits new work has its own bound from `--queue-capacity` (0 = unbounded). The
+    // ApiManager's response queue has none: responses belong to requests that were already admitted and must not be lost.
+    TaskQueue<Task> scheduler_queue(queue_capacities.scheduler);
+    TaskQueue<Task> api_manager_request_queue(queue_capacities.api);
     TaskQueue<ApiResponse> api_manager_response_queue;
-    TaskQueue<Task> event_loop_macrotask_queue;
-    TaskQueue<Task> event_loop_microtask_queue;
+    TaskQueue<Task> event_loop_macrotask_queue(queue_capacities.macro);
+    TaskQueue<Task> event_loop_microtask_queue(queue_capacities.micro);
     std::cout << "[Scheduler/Main]: Task queues created." << std::endl;
 
-    // Create 3 alarms, one for each main actor thread.
+    // Admission control for tasks entering the Scheduler's queue. Its error callback reports every
+    // rejected or shed task and removes it from the in-flight count, since it will never execute.
+    AdmissionController admission([&](const Task& dropped, PushResult reason) {
+        std::cerr << "  [Admission] " << (reason == PushResult::SHED ? "SHED" : "REJECTED") << " Task ID " << dropped.id
+                  << " (callback " << dropped.callback_id << "): queue full." << std::endl;
+        tasks_in_flight.fetch_sub(1, std::memory_order_release);
+    });
+    admission.set_policy(TaskSource::API_WORKER, TaskType::MACROTASK, macro_overflow);
+    admission.set_policy(TaskSource::API_WORKER, TaskType::MICROTASK, micro_overflow);
+
+    // Create the alarms for the Scheduler and the EventLoop.
     // Each alarm's wake-up condition is a lambda that checks if its actor's queue(s) are non-empty.
     Alarm scheduler_alarm([&]() { return !scheduler_queue.isEmpty(); });
 
-    Alarm api_manager_alarm([&]() { return !api_manager_request_queue.isEmpty() || !api_manager_response_queue.isEmpty(); });
+    // The ApiManager waits on an I/O reactor instead of an Alarm: it sleeps until either the
+    // Scheduler notifies it of new requests or some of its in-flight requests complete.
+    IoReactor api_manager_reactor;
+
+    // Highest number of requests the ApiManager has had in flight at once; written only by its thread.
+    std::atomic<std::size_t> api_peak_in_flight(0);
     
     Alarm event_loop_alarm([&]() {
         return !event_loop_macrotask_queue.isEmpty() || !event_loop_microtask_queue.isEmpty();
@@ -249,9 +634,13 @@ int main() {
 
     std::cout << "[Scheduler/Main]: Alarms created and configured." << std::endl;
 
+    // Scheduler→EventLoop hand-off latency, the figure that thread placement and busy polling act upon.
+    HandoffLatency handoff_latency;
+
     // 2. Launch the Scheduler Thread.
     // This thread acts as a central router, directing tasks from their source to their destination.
     std::thread scheduler_thread([&]() {
+        tuning.apply("scheduler", "js-scheduler", std::cout);
         std::cout << "[Scheduler]: Thread started." << std::endl;
 
         while (true) { // The Scheduler's main loop.
@@ -262,14 +651,18 @@ int main() {
                 std::cout << "[Scheduler]: Popped Task (ID " << task.id << "). Analyzing source..." << std::endl;
 
                 // 2. Route the task based on its origin.
+                // Hand-offs to the other actors BLOCK when their queues are full: the Scheduler stops
+                // draining its own queue, which pushes the backpressure up to the admission policies.
+                std::optional<Task> not_delivered; // Only used by REJECT/SHED policies, never by BLOCK.
                 if (task.source == TaskSource::API_WORKER) {
                     // Task comes from an API response, destined for the EventLoop.
+                    task.routed_at = std::chrono::steady_clock::now();
                     if (task.is_promise) {
                         std::cout << "  [Scheduler] API task is a promise. Routing to MICROTASK queue." << std::endl;
-                        event_loop_microtask_queue.push_back(std::move(task));
+                        event_loop_microtask_queue.offer(std::move(task), OverflowPolicy::BLOCK, not_delivered);
                     } else {
                         std::cout << "  [Scheduler] API task is standard. Routing to MACROTASK queue." << std::endl;
-                        event_loop_macrotask_queue.push_back(std::move(task));
+                        event_loop_macrotask_queue.offer(std::move(task), OverflowPolicy::BLOCK, not_delivered);
                     }
                     
                     // Wake up the EventLoop to process the new task.
@@ -279,10 +672,10 @@ int main() {
                     // Task comes from the Call Stack (JS), it's a request for the ApiManager.
                     std::cout << "  [Scheduler] EventLoop task. Routing to API_MANAGER queue." << std::endl;
                     
-                    api_manager_request_queue.push_back(std::move(task));
+                    api_manager_request_queue.offer(std::move(task), OverflowPolicy::BLOCK, not_delivered);
                     
                     // Wake up the ApiManager to process the new request.
-                    api_manager_alarm.notify();
+                    api_manager_reactor.notify();
                 
                 } else {
                     // Handle other cases or potential errors.
@@ -300,35 +693,58 @@ int main() {
 
 
     // 3. Launch the API Manager Thread.
-    // This thread manages asynchronous I/O operations, spawning workers and processing their results.
+    // This thread manages asynchronous I/O operations. Every request is registered as a non-blocking
+    // operation in the reactor, so a single thread keeps all of them in flight at once.
     std::thread api_manager_thread([&]() {
+        tuning.apply("api", "js-api-manager", std::cout);
         std::cout << "[ApiManager]: Thread started." << std::endl;
 
         // Hash map to maintain the context of in-flight API requests.
         // Key: task_id, Value: The original Task object.
         std::unordered_map<long long, Task> pending_api_tasks;
 
+        // Launch order and launch time of each in-flight request, used to record and replay API responses.
+        std::unordered_map<long long, std::pair<std::uint64_t, std::chrono::steady_clock::time_point>> request_launches;
+        std::uint64_t next_request_ordinal = 0;
+
+        // Requests currently in flight in the reactor, keyed by task_id (the reactor's completion token).
+        std::unordered_map<long long, std::pair<ApiRequest, ApiWorkerScript>> in_flight_requests;
+        std::vector<long long> completed_tokens;
+
         while (true) { // The ApiManager's main loop.  
 
             // --- PHASE 1: PROCESS NEW REQUESTS ---
-            while (!api_manager_request_queue.isEmpty()) {
+            // At most `inflight` requests are started. The rest stay in the bounded request queue, so once
+            // it fills up the Scheduler blocks on it and the backpressure reaches the admission policies.
+            while (!api_manager_request_queue.isEmpty()
+                   && (queue_capacities.in_flight == 0 || in_flight_requests.size() < queue_capacities.in_flight)) {
                 // Dequeue the task and store it in our map of pending operations.
                 Task task = api_manager_request_queue.pop();
                 std::cout << "[ApiManager]: New request RECEIVED (ID: " << task.id << "). Storing context..." << std::endl;
                 pending_api_tasks[task.id] = task;
 
-                // Prepare the request object for the worker thread.
+                // Prepare the request object for the external API.
                 // This is for security: we don't want to share internal/unnecesary data with external APIs
                 ApiRequest request_to_api;
                 request_to_api.task_id = task.id;
                 request_to_api.data = task.data;
 
-                std::cout << "  [ApiManager] Launching worker for Task ID: " << task.id << std::endl;
-                sendAPIRequest(
-                    std::move(request_to_api),
-                    api_manager_response_queue, // The queue for workers to send responses to.
-                    api_manager_alarm           // This manager's own alarm for notification.
-                );
+                // In replay mode the API reproduces the recorded latency and payload for this request.
+                std::uint64_t ordinal = next_request_ordinal++;
+                request_launches[task.id] = {ordinal, std::chrono::steady_clock::now()};
+                ApiWorkerScript script;
+                if (ordinal < replay_api_scripts.size()) {
+                    script = replay_api_scripts[ordinal];
+                } else if (replay_log && replay_fast) {
+                    script.latency = std::chrono::microseconds(0);
+                }
+
+                std::cout << "  [ApiManager] Starting timed request for Task ID: " << task.id << std::endl;
+                api_manager_reactor.start_timer(task.id, script.latency);
+                in_flight_requests.emplace(task.id, std::make_pair(std::move(request_to_api), std::move(script)));
+                if (in_flight_requests.size() > api_peak_in_flight.load(std::memory_order_relaxed)) {
+                    api_peak_in_flight.store(in_flight_requests.size(), std::memory_order_relaxed);
+                }
             }
 
             // --- PHASE 2: PROCESS COMPLETED RESPONSES ---
@@ -343,6 +759,16 @@ int main() {
                     Task completed_task = std::move(pending_task_it->second); //movemos la tarea encuentrada
                     pending_api_tasks.erase(pending_task_it);
 
+                    auto launch_it = request_launches.find(api_response.task_id);
+                    if (recorder && launch_it != request_launches.end()) {
+                        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - launch_it->second.second);
+                        const std::string* text = std::any_cast<std::string>(&api_response.data);
+                        recorder->record_api_response(launch_it->second.first, latency.count(), text ? *text : std::string());
+                    }
+                    if (launch_it != request_launches.end()) {
+                        request_launches.erase(launch_it);
+                    }
+
                     // Re-hydrate the task with the response data and update its source.
                     completed_task.source = TaskSource::API_WORKER;  
                     completed_task.data = api_response.data;  
@@ -366,10 +792,28 @@ int main() {
             }
 
             // --- PHASE 3: WAIT ---
-            // If there's no activity in either queue, go to sleep.
-            std::cout << "[ApiManager]: No pending activity. Going to sleep..." << std::endl;
-            api_manager_alarm.wait();
-            std::cout << "[ApiManager]: Woken up by a notification." << std::endl;
+            // Sleep in the reactor until new requests arrive or in-flight ones complete. Every request
+            // that completed during the wait is delivered to the response queue as one batch.
+            std::cout << "[ApiManager]: No pending activity (" << in_flight_requests.size() << " requests in flight). Going to sleep..." << std::endl;
+            completed_tokens.clear();
+            api_manager_reactor.wait(completed_tokens);
+
+            std::vector<ApiResponse> completed_batch;
+            completed_batch.reserve(completed_tokens.size());
+            for (long long token : completed_tokens) {
+                auto request_it = in_flight_requests.find(token);
+                if (request_it == in_flight_requests.end()) {
+                    continue;
+                }
+                completed_batch.push_back(completeAPIRequest(request_it->second.first, std::move(request_it->second.second)));
+                in_flight_requests.erase(request_it);
+            }
+            if (!completed_batch.empty()) {
+                std::cout << "[ApiManager]: Woken up with " << completed_batch.size() << " completed request(s)." << std::endl;
+                api_manager_response_queue.push_back_batch(std::move(completed_batch));
+            } else {
+                std::cout << "[ApiManager]: Woken up by a notification." << std::endl;
+            }
         }
     });
     std::cout << "[Main]: ApiManager thread launched." << std::endl;
@@ -378,36 +822,73 @@ int main() {
     // 4. Launch the Event Loop Thread.
     // This thread simulates the single-threaded nature of JavaScript's execution environment.
     std::thread event_loop_thread([&]() {
+        tuning.apply("eventloop", "js-event-loop", std::cout);
         std::cout << "[EventLoop]: Thread started." << std::endl;
+
+        // Runs one callback on the "call stack" and reports its duration to the renderer,
+        // which blames the longest task when a frame misses its budget.
+        // A suspended async frame is resumed in place; anything else is looked up in the ClosureHeap.
+        auto run_callback = [&](long long callback_id, const std::any& data, const std::shared_ptr<AsyncFrame>& resume_frame = nullptr) {
+            auto started = FrameRenderer::Clock::now();
+            if (resume_frame) {
+                executeStackJS(std::move(*resume_frame), data, closure_heap, scheduler_queue, scheduler_alarm, admission, tasks_in_flight, renderer, event_loop_microtask_queue, event_loop_macrotask_queue);
+            } else {
+                // TO-DO: add error handling
+                AsyncFrame frame;
+                frame.callback = closure_heap.get(callback_id);
+                executeStackJS(std::move(frame), data, closure_heap, scheduler_queue, scheduler_alarm, admission, tasks_in_flight, renderer, event_loop_microtask_queue, event_loop_macrotask_queue);
+            }
+            renderer.note_task(callback_id, FrameRenderer::Clock::now() - started);
+            tasks_in_flight.fetch_sub(1, std::memory_order_release);
+        };
+
+        // The microtask checkpoint: microtasks (like promise resolutions) are executed exhaustively.
+        auto drain_microtasks = [&]() {
+            while (!event_loop_microtask_queue.isEmpty()) {
+                Task micro_task = event_loop_microtask_queue.pop();
+                handoff_latency.record(std::chrono::steady_clock::now() - micro_task.routed_at);
+                run_callback(micro_task.callback_id, micro_task.data, micro_task.resume_frame);
+            }
+        };
+
         while (true) { // The EventLoop's main loop.
 
             // Phase 1: Process ONE macrotask (if available).
             // This models how browsers handle one macrotask per event loop tick.
             if (!event_loop_macrotask_queue.isEmpty()) {
                 Task macro_task = event_loop_macrotask_queue.pop();
-
-                // Retrieve the associated callback and execute it.
-                // TO-DO: add error handling
-                Callback cb_to_run = closure_heap.get(macro_task.callback_id);
-                executeStackJS(cb_to_run, macro_task.data, closure_heap, scheduler_queue, scheduler_alarm);
+                handoff_latency.record(std::chrono::steady_clock::now() - macro_task.routed_at);
+                run_callback(macro_task.callback_id, macro_task.data, macro_task.resume_frame);
             }
             
             // Phase 2: Process ALL pending microtasks.
-            // Microtasks (like promise resolutions) are executed exhaustively after each macrotask.
-            while (!event_loop_microtask_queue.isEmpty()) {
-                Task micro_task = event_loop_microtask_queue.pop();
-
-                // Retrieve the associated callback and execute it.
-                // TO-DO: add error handling
-                Callback cb_to_run = closure_heap.get(micro_task.callback_id);
-                executeStackJS(cb_to_run, micro_task.data, closure_heap, scheduler_queue, scheduler_alarm);
+            drain_microtasks();
+
+            // Phase 3: Render, if a frame is due.
+            // requestAnimationFrame callbacks run first (each followed by a microtask checkpoint),
+            // then the coalesced DOM batch is applied in a single commit.
+            auto now = FrameRenderer::Clock::now();
+            if (renderer.frame_due(now)) {
+                for (long long callback_id : renderer.take_animation_callbacks()) {
+                    run_callback(callback_id, std::any());
+                    drain_microtasks();
+                }
+                renderer.commit_frame(now);
             }
 
-            // Phase 3: If both queues are empty, wait for a new task.
+            // Phase 4: If both queues are empty, wait for a new task (or for the next frame, if one is pending).
+            // In busy-poll mode the EventLoop never sleeps: it spins straight back to Phase 1, so a new
+            // task is picked up without the cost of a condition-variable wake-up.
             if (event_loop_macrotask_queue.isEmpty() && event_loop_microtask_queue.isEmpty()) {
-                std::cout << "[EventLoop]: No more tasks. Going to sleep..." << std::endl;
-                event_loop_alarm.wait();
-                std::cout << "[EventLoop]: Woken up by a notification." << std::endl;
+                if (tuning.event_loop_busy_poll) {
+                    cpuRelax();
+                } else if (renderer.has_pending_work()) {
+                    event_loop_alarm.wait_until(renderer.frame_deadline());
+                } else {
+                    std::cout << "[EventLoop]: No more tasks. Going to sleep..." << std::endl;
+                    event_loop_alarm.wait();
+                    std::cout << "[EventLoop]: Woken up by a notification." << std::endl;
+                }
             }
         }
     });
@@ -416,7 +897,92 @@ int main() {
     std::cout << "--------------------------------------------------------\n" << std::endl;
     std::this_thread::sleep_for(std::chrono::seconds(1)); // Allow time for threads to initialize and go to sleep.
 
+    // --- REPLAY MODE ---
+    // Instead of reading commands from std::cin, re-register the recorded callbacks and re-inject
+    // the recorded tasks, either at their original offsets or back-to-back (--fast).
+    // The elapsed time until the engine drains is reported so replays can be used as benchmarks.
+    if (replay_log) {
+        std::cout << "[MAIN]: === REPLAY: " << replay_path << (replay_fast ? " (as fast as possible)" : " (recorded speed)") << " ===" << std::endl;
+        auto replay_start = std::chrono::steady_clock::now();
+
+        for (const auto& event : replay_log->events()) {
+            if (!replay_fast) {
+                std::this_thread::sleep_until(replay_start + std::chrono::microseconds(event.offset_us));
+            }
+            switch (event.kind) {
+                case LogEventKind::CALLBACK_REGISTERED: {
+                    long long id = closure_heap.register_callback(event.callback.instructions);
+                    if (id != event.callback.id) {
+                        std::cerr << "[MAIN]: WARNING! Replayed callback got ID " << id << " but was recorded as " << event.callback.id << "." << std::endl;
+                    }
+                    break;
+                }
+                case LogEventKind::TASK_INJECTED: {
+                    Task task = event.task;
+                    task.id = Task::generate_id();
+                    reportAdmission(injectTask(std::move(task), scheduler_queue, scheduler_alarm, admission, tasks_in_flight, nullptr));
+                    break;
+                }
+                default:
+                    // API responses are served by the ApiManager; END only marks the recorded duration.
+                    break;
+            }
+        }
+
+        waitUntilDrained(tasks_in_flight, renderer);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - replay_start);
+        std::cout << "[MAIN]: === REPLAY COMPLETE: engine drained in " << elapsed.count() << " us ===" << std::endl;
+        renderer.report(std::cout);
+        admission.report(std::cout);
+        std::cout << "[ApiManager]: Peak of " << api_peak_in_flight.load() << " requests in flight at once." << std::endl;
+        tuning.report(std::cout);
+        handoff_latency.report(std::cout);
+
+        // The actor threads never return, so leave without running their destructors.
+        std::exit(0);
+    }
+
+    // --- SCENARIO MODE ---
+    // The scenario's injection schedule, loaded before the threads started, is played against the running engine.
+    if (!scenario_path.empty()) {
+        std::cout << "[MAIN]: === SCENARIO: " << scenario_path << " ===" << std::endl;
+        if (recorder) {
+            recorder->start();
+        }
+        auto run_start = std::chrono::steady_clock::now();
+        for (auto& injection : scenario_schedule) {
+            std::this_thread::sleep_until(run_start + std::chrono::milliseconds(injection.at_ms));
+
+            Task task;
+            task.id = Task::generate_id();
+            task.source = TaskSource::API_WORKER; // Scenario events come from the "outside world", like the control panel ones.
+            task.action = TaskAction::RESPONSE;
+            task.type = injection.is_promise ? TaskType::MICROTASK : TaskType::MACROTASK;
+            task.callback_id = injection.callback_id;
+            task.is_promise = injection.is_promise;
+            task.data = std::move(injection.data);
+            reportAdmission(injectTask(std::move(task), scheduler_queue, scheduler_alarm, admission, tasks_in_flight, recorder.get()));
+        }
+
+        waitUntilDrained(tasks_in_flight, renderer);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - run_start);
+        std::cout << "[MAIN]: === SCENARIO COMPLETE: engine drained in " << elapsed.count() << " us ===" << std::endl;
+        renderer.report(std::cout);
+        admission.report(std::cout);
+        std::cout << "[ApiManager]: Peak of " << api_peak_in_flight.load() << " requests in flight at once." << std::endl;
+        tuning.report(std::cout);
+        handoff_latency.report(std::cout);
+
+        if (recorder) {
+            recorder->close();
+        }
+        std::exit(0);
+    }
+
     // --- 3. INTERACTIVE COMMAND LOOP ---
+    if (recorder) {
+        recorder->start();
+    }
     while (true) {
         std::cout << "\n==================== JS ENGINE CONTROL PANEL ====================" << std::endl;
         std::cout << "Choose an action to inject into the engine:" << std::endl;
@@ -431,16 +997,24 @@ int main() {
 
         switch (choice) {
             case '1':
-                simulateFetchThen(closure_heap, scheduler_queue, scheduler_alarm);
+                simulateFetchThen(closure_heap, scheduler_queue, scheduler_alarm, admission, tasks_in_flight, recorder.get());
                 std::this_thread::sleep_for(std::chrono::seconds(4)); // Pause to allow user to read output
                 break;
             case '2':
-                simulateDomClick(closure_heap, scheduler_queue, scheduler_alarm);
+                simulateDomClick(closure_heap, scheduler_queue, scheduler_alarm, admission, tasks_in_flight, recorder.get());
                 std::this_thread::sleep_for(std::chrono::seconds(1));
                 break;
             case 'q':
             case 'Q':
                 std::cout << "[MAIN]: Shutdown initiated." << std::endl;
+                renderer.report(std::cout);
+                admission.report(std::cout);
+                std::cout << "[ApiManager]: Peak of " << api_peak_in_flight.load() << " requests in flight at once." << std::endl;
+                tuning.report(std::cout);
+                handoff_latency.report(std::cout);
+                if (recorder) {
+                    recorder->close(); // Flush the log before the process goes away.
+                }
                 // In a real app, you would signal threads to exit gracefully.
                 // For this simulation, we just exit.
                 return 0;